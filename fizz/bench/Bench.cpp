@@ -0,0 +1,55 @@
+#include "Bench.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace Fizz;
+
+/* A scenario that can be timed from the command line */
+struct Benchmark {
+	const char* name;
+	const char* description;
+	void (*run)();
+};
+
+static const Benchmark s_Benchmarks[] = {
+	{"gjk", "GJK queries on 200k random circle and polygon pairs", RunGJKBenchmark},
+	{"kernels", "Closed form circle kernels checked against GJK, and both timed",
+	 RunKernelBenchmark},
+	{"support", "Polygon support queries against a scalar loop, from 4 to 200 vertices",
+	 RunSupportBenchmark},
+	{"narrowphase", "3000 polygons stepped on one thread, and pair queries with and without caches",
+	 RunNarrowPhaseBenchmark},
+	{"threads", "A pile of 3000 boxes on 1, 2, 4 and 8 threads, checked to end up identical",
+	 RunThreadBenchmark},
+};
+
+/* Headless benchmarks for the physics core. Run with the name of a benchmark to run it, "all" to
+   run every benchmark, or nothing to list them. Timings are only meaningful in a Release or Dist
+   build.
+ */
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::printf("usage: %s <benchmark | all>\n\n", argv[0]);
+		for (const Benchmark& benchmark : s_Benchmarks)
+			std::printf("  %-12s %s\n", benchmark.name, benchmark.description);
+		return 0;
+	}
+
+	bool found = false;
+	for (const Benchmark& benchmark : s_Benchmarks) {
+		if (std::strcmp(argv[1], "all") != 0 && std::strcmp(argv[1], benchmark.name) != 0)
+			continue;
+
+		std::printf("== %s: %s\n", benchmark.name, benchmark.description);
+		benchmark.run();
+		found = true;
+	}
+
+	if (!found) {
+		std::printf("unknown benchmark: %s\n", argv[1]);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+namespace Fizz {
+	/* Measures wall clock time from when it is created */
+	class BenchTimer {
+	  public:
+		BenchTimer() : m_Start(std::chrono::steady_clock::now()) {}
+
+		/* Gets the time since the timer was created, in milliseconds */
+		inline double GetMilliseconds() const {
+			std::chrono::duration<double, std::milli> elapsed =
+				std::chrono::steady_clock::now() - m_Start;
+			return elapsed.count();
+		}
+
+	  private:
+		std::chrono::steady_clock::time_point m_Start;
+	};
+
+	/* Source of random numbers for building benchmark scenes. Every benchmark starts from the
+	   same seed, so each run measures the same scene, and the checksums printed alongside the
+	   timings can be compared between builds.
+	 */
+	class BenchRandom {
+	  public:
+		BenchRandom(uint32_t seed = 1) : m_Engine(seed) {}
+
+		/* Gets a number in [min, max) */
+		inline float Float(float min, float max) {
+			return min + (max - min) * (m_Engine() / 4294967296.0f);
+		}
+		/* Gets a number in [0, count) */
+		inline uint32_t Index(uint32_t count) { return m_Engine() % count; }
+		/* Gets a point in the square from (min, min) to (max, max) */
+		inline glm::vec2 Point(float min, float max) {
+			float x = Float(min, max);
+			return glm::vec2(x, Float(min, max));
+		}
+		/* Gets a direction of unit length */
+		inline glm::vec2 Direction() {
+			float angle = Float(0.0f, 2.0f * 3.1415926f);
+			return glm::vec2(glm::cos(angle), glm::sin(angle));
+		}
+
+	  private:
+		std::mt19937 m_Engine;
+	};
+
+	// each benchmark, see the table in Bench.cpp for what they measure
+	void RunGJKBenchmark();
+	void RunKernelBenchmark();
+	void RunSupportBenchmark();
+	void RunNarrowPhaseBenchmark();
+	void RunThreadBenchmark();
+} // namespace Fizz
@@ -0,0 +1,73 @@
+#include "Bench.hpp"
+
+#include <cstdio>
+#include <vector>
+
+#include "Collisions/CollisionDetection.hpp"
+#include "Objects/Circle.hpp"
+#include "Objects/Polygon.hpp"
+
+using namespace Nutella;
+
+namespace Fizz {
+	// number of shapes pairs are picked from, and the number of pairs picked
+	static const uint32_t NUM_SHAPES = 1000;
+	static const uint32_t NUM_PAIRS = 200000;
+	// number of timed passes over every pair, after one untimed pass
+	static const uint32_t NUM_ROUNDS = 5;
+
+	void RunGJKBenchmark() {
+		BenchRandom random;
+
+		// circles and each built in polygon, packed closely enough that about a third of the pairs
+		// overlap, so both GJK and EPA are measured
+		std::vector<Ref<Shape>> shapes;
+		for (uint32_t i = 0; i < NUM_SHAPES; i++) {
+			uint32_t type = random.Index((uint32_t) PolygonType::COUNT + 1);
+			Ref<Shape> shape = type == (uint32_t) PolygonType::COUNT
+								   ? Ref<Shape>(CreateRef<Circle>(0.0f))
+								   : Ref<Shape>(CreateRef<Polygon>((PolygonType) type));
+
+			float size = random.Float(0.2f, 0.6f);
+			shape->SetTransform({random.Point(-1.0f, 1.0f), random.Float(0.0f, 6.28f),
+								 glm::vec2(size, random.Float(0.2f, 0.6f))});
+			shape->UpdateCache();
+			shapes.push_back(shape);
+		}
+
+		std::vector<std::pair<uint32_t, uint32_t>> pairs;
+		std::vector<glm::vec2> directions;
+		for (uint32_t i = 0; i < NUM_PAIRS; i++) {
+			uint32_t first = random.Index(NUM_SHAPES);
+			uint32_t second = (first + 1 + random.Index(NUM_SHAPES - 1)) % NUM_SHAPES;
+			pairs.push_back({first, second});
+			directions.push_back(random.Direction());
+		}
+
+		// the checksum sums every result, so a change to any result shows up
+		uint32_t numColliding = 0;
+		double checksum = 0.0;
+		double milliseconds = 0.0;
+		for (uint32_t round = 0; round <= NUM_ROUNDS; round++) {
+			numColliding = 0;
+			checksum = 0.0;
+
+			BenchTimer timer;
+			for (uint32_t i = 0; i < NUM_PAIRS; i++) {
+				Collision collision =
+					GJKGetCollision(*shapes[pairs[i].first], *shapes[pairs[i].second],
+									directions[i]);
+				numColliding += collision.exists;
+				checksum += collision.exists ? collision.penetrationDepth
+											 : collision.separationDist;
+			}
+
+			if (round > 0)
+				milliseconds += timer.GetMilliseconds();
+		}
+
+		double perQuery = milliseconds * 1e6 / (NUM_ROUNDS * (double) NUM_PAIRS);
+		std::printf("%u pairs, %u colliding: %.1f ns per query (checksum %.6f)\n", NUM_PAIRS,
+					numColliding, perQuery, checksum);
+	}
+} // namespace Fizz
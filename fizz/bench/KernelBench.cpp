@@ -0,0 +1,130 @@
+#include "Bench.hpp"
+
+#include <cstdio>
+#include <vector>
+
+#include "Collisions/CollisionDetection.hpp"
+#include "Collisions/CollisionDispatch.hpp"
+#include "Objects/Circle.hpp"
+#include "Objects/Polygon.hpp"
+
+using namespace Nutella;
+
+namespace Fizz {
+	// number of pairs checked against GJK, and the number timed
+	static const uint32_t NUM_CHECKED_PAIRS = 20000;
+	static const uint32_t NUM_TIMED_PAIRS = 200000;
+	// number of timed passes over every pair, after one untimed pass
+	static const uint32_t NUM_ROUNDS = 5;
+	// overlaps deeper than this are reported separately, since EPA's polytope only approximates
+	// the curved boundary of a circle and its error grows as circles sink in
+	static const float DEEP_OVERLAP = 0.1f;
+
+	/** Creates a circle (if circle is set) or a random built in polygon, somewhere near the
+	 *  origin
+	 */
+	static Ref<Shape> CreateShape(BenchRandom& random, bool circle) {
+		Ref<Shape> shape = circle ? Ref<Shape>(CreateRef<Circle>(0.0f))
+								  : Ref<Shape>(CreateRef<Polygon>(
+										(PolygonType) random.Index((uint32_t) PolygonType::COUNT)));
+
+		float size = random.Float(0.2f, 0.6f);
+		shape->SetTransform({random.Point(-0.8f, 0.8f), random.Float(0.0f, 6.28f),
+							 glm::vec2(size, random.Float(0.2f, 0.6f))});
+		shape->UpdateCache();
+		return shape;
+	}
+
+	/** Checks the closed form kernels against GJK on pairs with at least one circle */
+	static void CheckAgreement(BenchRandom& random) {
+		uint32_t numMismatched = 0, numShallow = 0, numDeep = 0;
+		float maxShallowError = 0.0f, maxDeepError = 0.0f, maxSeparatedError = 0.0f;
+		float minNormalDot = 1.0f;
+
+		for (uint32_t i = 0; i < NUM_CHECKED_PAIRS; i++) {
+			Ref<Shape> circle = CreateShape(random, true);
+			Ref<Shape> other = CreateShape(random, random.Index(2) == 0);
+			glm::vec2 dir = random.Direction();
+
+			Collision kernel = GetCollision(*circle, *other, dir);
+			Collision gjk = GJKGetCollision(*circle, *other, dir);
+			if (kernel.exists != gjk.exists) {
+				numMismatched++;
+				continue;
+			}
+
+			if (!kernel.exists) {
+				float error = glm::abs(kernel.separationDist - gjk.separationDist);
+				maxSeparatedError = glm::max(maxSeparatedError, error);
+				continue;
+			}
+
+			float error = glm::abs(kernel.penetrationDepth - gjk.penetrationDepth);
+			if (kernel.penetrationDepth > DEEP_OVERLAP) {
+				numDeep++;
+				maxDeepError = glm::max(maxDeepError, error);
+			} else {
+				numShallow++;
+				maxShallowError = glm::max(maxShallowError, error);
+				minNormalDot = glm::min(minNormalDot, glm::dot(kernel.MTV, gjk.MTV));
+			}
+		}
+
+		std::printf("%u pairs with a circle, %u disagree on whether they collide\n",
+					NUM_CHECKED_PAIRS, numMismatched);
+		std::printf("  separated: max distance error %.6f\n", maxSeparatedError);
+		std::printf("  %u shallow overlaps: max depth error %.6f, min normal dot %.6f\n",
+					numShallow, maxShallowError, minNormalDot);
+		std::printf("  %u overlaps deeper than %.2f: max depth error %.6f\n", numDeep,
+					DEEP_OVERLAP, maxDeepError);
+	}
+
+	/** Times the dispatched routines against GJK for every pair on a mixed scene */
+	static void TimeQueries(BenchRandom& random) {
+		std::vector<std::pair<Ref<Shape>, Ref<Shape>>> pairs;
+		std::vector<glm::vec2> directions;
+		for (uint32_t i = 0; i < NUM_TIMED_PAIRS; i++) {
+			pairs.push_back({CreateShape(random, random.Index(2) == 0),
+							 CreateShape(random, random.Index(2) == 0)});
+			directions.push_back(random.Direction());
+		}
+
+		double kernelMilliseconds = 0.0, gjkMilliseconds = 0.0;
+		uint32_t numKernelColliding = 0, numGJKColliding = 0;
+		for (uint32_t round = 0; round <= NUM_ROUNDS; round++) {
+			numKernelColliding = 0;
+			numGJKColliding = 0;
+
+			BenchTimer kernelTimer;
+			for (uint32_t i = 0; i < NUM_TIMED_PAIRS; i++) {
+				const auto& [p1, p2] = pairs[i];
+				numKernelColliding += GetCollision(*p1, *p2, directions[i]).exists;
+			}
+			double kernelTime = kernelTimer.GetMilliseconds();
+
+			BenchTimer gjkTimer;
+			for (uint32_t i = 0; i < NUM_TIMED_PAIRS; i++) {
+				const auto& [p1, p2] = pairs[i];
+				numGJKColliding += GJKGetCollision(*p1, *p2, directions[i]).exists;
+			}
+			double gjkTime = gjkTimer.GetMilliseconds();
+
+			if (round > 0) {
+				kernelMilliseconds += kernelTime;
+				gjkMilliseconds += gjkTime;
+			}
+		}
+
+		double scale = 1e6 / (NUM_ROUNDS * (double) NUM_TIMED_PAIRS);
+		std::printf("%u mixed pairs: %.1f ns per query dispatched (%u colliding), "
+					"%.1f ns per query with GJK (%u colliding)\n",
+					NUM_TIMED_PAIRS, kernelMilliseconds * scale, numKernelColliding,
+					gjkMilliseconds * scale, numGJKColliding);
+	}
+
+	void RunKernelBenchmark() {
+		BenchRandom random;
+		CheckAgreement(random);
+		TimeQueries(random);
+	}
+} // namespace Fizz
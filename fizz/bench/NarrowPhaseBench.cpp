@@ -0,0 +1,157 @@
+#include "Bench.hpp"
+
+#include <cstdio>
+#include <vector>
+
+#include "PhysicsEnvironment.hpp"
+#include "Collisions/CollisionDispatch.hpp"
+#include "Objects/Polygon.hpp"
+
+using namespace Nutella;
+
+namespace Fizz {
+	// number of polygons in the scene, and the number of steps (or frames of queries) timed
+	static const uint32_t NUM_POLYGONS = 3000;
+	static const uint32_t NUM_STEPS = 100;
+	// vertex count of the large polygons, past where support queries switch to hill climbing
+	static const uint32_t LARGE_POLYGON_POINTS = 32;
+	// how far each polygon moves and turns between frames of the cached query comparison
+	static const float MAX_FRAME_MOVE = 0.005f;
+	static const float MAX_FRAME_TURN = 0.02f;
+
+	/** Creates one of the polygons a scene is built from: a random built in polygon, or the
+	 *  shared large polygon if given
+	 */
+	static Ref<Polygon> CreatePolygon(BenchRandom& random,
+									  const Ref<const PolygonGeometry>& large) {
+		if (large)
+			return CreateRef<Polygon>(large);
+		return CreateRef<Polygon>((PolygonType) random.Index((uint32_t) PolygonType::COUNT));
+	}
+
+	/** Steps a loose cloud of polygons drifting downwards on one thread, and reports the time per
+	 *  step. Every stage of the step is included; the narrow phase is most of it.
+	 */
+	static void TimeSteps(const Ref<const PolygonGeometry>& large) {
+		BenchRandom random;
+		PhysicsEnvironment environment(BroadPhaseType::DYNAMIC_TREE, 1);
+		environment.SetGravity(glm::vec2(0.0f, -0.1f));
+
+		for (uint32_t i = 0; i < NUM_POLYGONS; i++) {
+			Ref<Polygon> polygon = CreatePolygon(random, large);
+			float size = random.Float(0.1f, 0.4f);
+			environment.Create(polygon, {random.Point(-20.0f, 20.0f), random.Float(0.0f, 6.28f),
+										 glm::vec2(size, size)});
+		}
+
+		// one untimed step, so every pair starts with its cache filled
+		environment.Update(Timestep(1.0f / 60.0f));
+
+		uint64_t numCollisions = 0;
+		BenchTimer timer;
+		for (uint32_t step = 0; step < NUM_STEPS; step++) {
+			environment.Update(Timestep(1.0f / 60.0f));
+			numCollisions += environment.GetCollisions().size();
+		}
+		double milliseconds = timer.GetMilliseconds();
+
+		std::printf("  %u steps: %.2f ms per step, %.1f collisions per step\n", NUM_STEPS,
+					milliseconds / NUM_STEPS, numCollisions / (double) NUM_STEPS);
+	}
+
+	/** Queries the same moving pairs of polygons every frame with and without a cache, and reports
+	 *  the time per query of each
+	 */
+	static void TimeCachedQueries(const Ref<const PolygonGeometry>& large) {
+		BenchRandom random;
+
+		// pairs placed from deeply overlapping to a little apart, each moving steadily
+		struct MovingPolygon {
+			Ref<Polygon> polygon;
+			Transform start;
+			glm::vec2 position;
+			glm::vec2 velocity;
+			float angularVelocity;
+		};
+		std::vector<MovingPolygon> polygons;
+		for (uint32_t i = 0; i < NUM_POLYGONS; i++) {
+			glm::vec2 center =
+				i % 2 == 0 ? random.Point(-20.0f, 20.0f) : polygons.back().start.position;
+			float size = random.Float(0.1f, 0.4f);
+			Transform start = {center + random.Direction() * random.Float(0.0f, 0.8f),
+							   random.Float(0.0f, 6.28f), glm::vec2(size, size)};
+			polygons.push_back({CreatePolygon(random, large), start, start.position,
+								random.Direction() * random.Float(0.0f, MAX_FRAME_MOVE),
+								random.Float(-MAX_FRAME_TURN, MAX_FRAME_TURN)});
+		}
+
+		uint32_t numPairs = NUM_POLYGONS / 2;
+		std::vector<GJKCache> caches(numPairs);
+		double uncachedMilliseconds = 0.0, cachedMilliseconds = 0.0;
+		uint64_t numUncachedColliding = 0, numCachedColliding = 0;
+
+		for (uint32_t frame = 0; frame <= NUM_STEPS; frame++) {
+			for (MovingPolygon& moving : polygons) {
+				moving.position = moving.start.position + moving.velocity * (float) frame;
+				moving.polygon->SetTransform(
+					{moving.position, moving.start.rotation + moving.angularVelocity * frame,
+					 moving.start.scale});
+				moving.polygon->UpdateCache();
+			}
+
+			uint32_t uncachedColliding = 0, cachedColliding = 0;
+			BenchTimer uncachedTimer;
+			for (uint32_t i = 0; i < numPairs; i++) {
+				const MovingPolygon& p1 = polygons[2 * i];
+				const MovingPolygon& p2 = polygons[2 * i + 1];
+				uncachedColliding += PolygonPolygonCollision(*p1.polygon, *p2.polygon,
+															 p2.position - p1.position)
+										 .exists;
+			}
+			double uncachedTime = uncachedTimer.GetMilliseconds();
+
+			BenchTimer cachedTimer;
+			for (uint32_t i = 0; i < numPairs; i++) {
+				const MovingPolygon& p1 = polygons[2 * i];
+				const MovingPolygon& p2 = polygons[2 * i + 1];
+				cachedColliding += PolygonPolygonCollision(*p1.polygon, *p2.polygon, caches[i],
+														   p2.position - p1.position)
+									   .exists;
+			}
+			double cachedTime = cachedTimer.GetMilliseconds();
+
+			// the first frame fills the caches, and is not timed
+			if (frame > 0) {
+				uncachedMilliseconds += uncachedTime;
+				cachedMilliseconds += cachedTime;
+				numUncachedColliding += uncachedColliding;
+				numCachedColliding += cachedColliding;
+			}
+		}
+
+		double scale = 1e6 / (NUM_STEPS * (double) numPairs);
+		std::printf("  %u pairs over %u frames: %.1f ns per query uncached (%llu colliding), "
+					"%.1f ns cached (%llu colliding)\n",
+					numPairs, NUM_STEPS, uncachedMilliseconds * scale,
+					(unsigned long long) numUncachedColliding, cachedMilliseconds * scale,
+					(unsigned long long) numCachedColliding);
+	}
+
+	void RunNarrowPhaseBenchmark() {
+		std::vector<glm::vec2> points;
+		for (uint32_t i = 0; i < LARGE_POLYGON_POINTS; i++) {
+			float theta = 2.0f * 3.1415926f * i / LARGE_POLYGON_POINTS;
+			points.push_back(glm::vec2(glm::cos(theta), glm::sin(theta)));
+		}
+		Ref<const PolygonGeometry> large = CreateRef<const PolygonGeometry>(points);
+
+		std::printf("%u built in polygons, one thread\n", NUM_POLYGONS);
+		TimeSteps(nullptr);
+		TimeCachedQueries(nullptr);
+
+		std::printf("%u polygons with %u vertices, one thread\n", NUM_POLYGONS,
+					LARGE_POLYGON_POINTS);
+		TimeSteps(large);
+		TimeCachedQueries(large);
+	}
+} // namespace Fizz
@@ -0,0 +1,114 @@
+#include "Bench.hpp"
+
+#include <cstdio>
+#include <vector>
+
+#include "Objects/Polygon.hpp"
+
+using namespace Nutella;
+
+namespace Fizz {
+	// vertex counts timed, either side of the count where polygons switch to hill climbing
+	static const uint32_t VERTEX_COUNTS[] = {4, 8, 16, 31, 32, 64, 200};
+	// number of directions queried, and the number of queries timed for each polygon
+	static const uint32_t NUM_DIRECTIONS = 4096;
+	static const uint32_t NUM_QUERIES = 2000000;
+	// angle between consecutive directions when they turn slowly, as they do between GJK
+	// iterations or frames
+	static const float COHERENT_STEP = 0.01f;
+
+	/** Finds the support point the way polygons did before vectorizing: a scalar loop over every
+	 *  transformed vertex
+	 */
+	static glm::vec2 ReferenceSupport(const Polygon& polygon, const glm::vec2& dir) {
+		const std::vector<glm::vec2>& points = polygon.GetTransformedPoints();
+
+		glm::vec2 support = points[0];
+		float maxSupportDist = glm::dot(points[0], dir);
+		for (uint32_t i = 1; i < points.size(); i++) {
+			float currSupportDist = glm::dot(points[i], dir);
+			if (currSupportDist > maxSupportDist) {
+				maxSupportDist = currSupportDist;
+				support = points[i];
+			}
+		}
+
+		return support;
+	}
+
+	/** Times support queries over a list of directions, in nanoseconds per query. Every support
+	 *  point is added to sum, so the queries cannot be optimized out.
+	 */
+	template <typename SupportFunc>
+	static double TimeSupport(const std::vector<glm::vec2>& directions, SupportFunc support,
+							  glm::vec2& sum) {
+		// one untimed pass to warm caches, and the hill climb's starting vertex
+		for (const glm::vec2& dir : directions)
+			sum += support(dir);
+
+		BenchTimer timer;
+		for (uint32_t i = 0; i < NUM_QUERIES; i++)
+			sum += support(directions[i % NUM_DIRECTIONS]);
+		return timer.GetMilliseconds() * 1e6 / NUM_QUERIES;
+	}
+
+	/** Counts the directions where Support returns a point less far along than the reference.
+	 *  Equally distant vertices may be returned in place of each other.
+	 */
+	static uint32_t CountShortfalls(const Polygon& polygon,
+									const std::vector<glm::vec2>& directions) {
+		uint32_t numShort = 0;
+		for (const glm::vec2& dir : directions) {
+			float expected = glm::dot(ReferenceSupport(polygon, dir), dir);
+			numShort += glm::dot(polygon.Support(dir), dir) < expected;
+		}
+		return numShort;
+	}
+
+	void RunSupportBenchmark() {
+		BenchRandom random;
+
+		std::vector<glm::vec2> randomDirections, coherentDirections;
+		float angle = 0.0f;
+		for (uint32_t i = 0; i < NUM_DIRECTIONS; i++) {
+			randomDirections.push_back(random.Direction());
+			coherentDirections.push_back(glm::vec2(glm::cos(angle), glm::sin(angle)));
+			angle += COHERENT_STEP;
+		}
+
+		std::printf("ns per query   %-22s %-22s\n", "random directions", "turning directions");
+		std::printf("vertices       %-10s %-11s %-10s %-11s\n", "reference", "Support", "reference",
+					"Support");
+
+		for (uint32_t numPoints : VERTEX_COUNTS) {
+			// a regular polygon, so every vertex is the support point for some direction
+			std::vector<glm::vec2> points;
+			for (uint32_t i = 0; i < numPoints; i++) {
+				float theta = 2.0f * 3.1415926f * i / numPoints;
+				points.push_back(glm::vec2(glm::cos(theta), glm::sin(theta)));
+			}
+
+			Polygon polygon(points);
+			polygon.SetTransform({glm::vec2(1.0f, 2.0f), 0.3f, glm::vec2(1.5f, 0.5f)});
+			polygon.UpdateCache();
+
+			auto reference = [&](const glm::vec2& dir) { return ReferenceSupport(polygon, dir); };
+			auto support = [&](const glm::vec2& dir) { return polygon.Support(dir); };
+
+			uint32_t numShort = CountShortfalls(polygon, randomDirections) +
+								CountShortfalls(polygon, coherentDirections);
+
+			glm::vec2 sum(0.0f);
+			double times[4] = {
+				TimeSupport(randomDirections, reference, sum),
+				TimeSupport(randomDirections, support, sum),
+				TimeSupport(coherentDirections, reference, sum),
+				TimeSupport(coherentDirections, support, sum),
+			};
+
+			std::printf("%-14u %-10.1f %-11.1f %-10.1f %-11.1f (%u short, checksum %.0f)\n",
+						numPoints, times[0], times[1], times[2], times[3], numShort,
+						sum.x + sum.y);
+		}
+	}
+} // namespace Fizz
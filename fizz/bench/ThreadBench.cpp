@@ -0,0 +1,84 @@
+#include "Bench.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "PhysicsEnvironment.hpp"
+#include "Objects/Polygon.hpp"
+
+using namespace Nutella;
+
+namespace Fizz {
+	// thread counts the pile is simulated on
+	static const uint32_t THREAD_COUNTS[] = {1, 2, 4, 8};
+	// boxes across and up the pile, and the number of steps timed
+	static const uint32_t PILE_WIDTH = 60;
+	static const uint32_t PILE_HEIGHT = 50;
+	static const uint32_t NUM_STEPS = 120;
+
+	/** Where a body ended up, compared bit for bit between thread counts */
+	struct FinalPose {
+		glm::vec2 position;
+		float rotation;
+	};
+
+	/** Drops a pile of boxes onto a floor, with sleeping off so every contact is solved every
+	 *  step. Returns the time per step, and fills poses with where each body ended up.
+	 */
+	static double SimulatePile(uint32_t numThreads, std::vector<FinalPose>& poses) {
+		PhysicsEnvironment environment(BroadPhaseType::DYNAMIC_TREE, numThreads);
+		environment.SetGravity(glm::vec2(0.0f, -9.8f));
+		environment.SetSleepEnabled(false);
+
+		Ref<PhysicsObject> floor = environment.Create(
+			CreateRef<Polygon>(PolygonType::SQUARE), {glm::vec2(0.0f, -1.0f), 0.0f,
+													  glm::vec2(100.0f, 1.0f)});
+		floor->SetInvMass(0.0f);
+
+		// every other row is nudged sideways, so the pile topples and settles unevenly
+		for (uint32_t i = 0; i < PILE_WIDTH; i++) {
+			for (uint32_t j = 0; j < PILE_HEIGHT; j++) {
+				glm::vec2 position(-0.1f * PILE_WIDTH + 0.2f * i + 0.01f * (j % 2),
+								   0.1f + 0.2f * j);
+				environment.Create(CreateRef<Polygon>(PolygonType::SQUARE),
+								   {position, 0.0f, glm::vec2(0.1f, 0.1f)});
+			}
+		}
+
+		BenchTimer timer;
+		for (uint32_t step = 0; step < NUM_STEPS; step++)
+			environment.Update(Timestep(1.0f / 60.0f));
+		double milliseconds = timer.GetMilliseconds();
+
+		poses.clear();
+		for (const Ref<PhysicsObject>& object : environment.GetObjects())
+			poses.push_back({object->GetPos(), object->GetRot()});
+
+		return milliseconds / NUM_STEPS;
+	}
+
+	void RunThreadBenchmark() {
+		std::printf("%u boxes on a floor, %u steps, %u hardware threads\n",
+					PILE_WIDTH * PILE_HEIGHT, NUM_STEPS, std::thread::hardware_concurrency());
+
+		std::vector<FinalPose> expected, poses;
+		for (uint32_t numThreads : THREAD_COUNTS) {
+			double perStep = SimulatePile(numThreads, numThreads == 1 ? expected : poses);
+
+			// the solver orders its work by the collisions alone, so every thread count should
+			// produce exactly the same bits
+			const char* result = "reference";
+			if (numThreads != 1) {
+				bool identical = poses.size() == expected.size() &&
+								 std::memcmp(poses.data(), expected.data(),
+											 poses.size() * sizeof(FinalPose)) == 0;
+				result = identical ? "identical" : "DIFFERENT";
+			}
+
+			std::printf("  %u threads: %.2f ms per step, final poses %s\n", numThreads, perStep,
+						result);
+		}
+	}
+} // namespace Fizz
@@ -2,15 +2,22 @@
 #version 330 core
 
 layout(location = 0) in vec4 a_position;
+layout(location = 1) in vec2 a_center;
+layout(location = 2) in float a_radius;
 
 uniform mat4 u_VP;
 uniform mat4 u_ModelTRS;
 
 // position of current pixel in world coords
 out vec4 v_FragWorldPos;
+// circle being drawn, in world coords
+out vec2 v_Center;
+out float v_Radius;
 
 void main() {
     v_FragWorldPos = u_ModelTRS * a_position;
+    v_Center = a_center;
+    v_Radius = a_radius;
 	gl_Position = u_VP * v_FragWorldPos;
 };
 
@@ -18,11 +25,8 @@ void main() {
 #version 330 core
 
 in vec4 v_FragWorldPos;
-
-// center of circle in world coords
-uniform vec2 u_Position;
-// radius of circle in world coords
-uniform float u_Radius;
+in vec2 v_Center;
+in float v_Radius;
 
 float circle(vec2 worldFragPos, vec2 worldCirclePos, float worldCircleRadius) {
     float dist = distance(worldFragPos, worldCirclePos);
@@ -32,7 +36,7 @@ float circle(vec2 worldFragPos, vec2 worldCirclePos, float worldCircleRadius) {
 layout(location = 0) out vec4 color;
 
 void main() {
-    float alpha = circle(v_FragWorldPos.xy, u_Position, u_Radius);
+    float alpha = circle(v_FragWorldPos.xy, v_Center, v_Radius);
 
     if (alpha == 0.0f) 
         discard;
@@ -0,0 +1,28 @@
+#include "BroadPhase.hpp"
+
+#include "Quadtree.hpp"
+#include "DynamicAABBTree.hpp"
+#include "SpatialHashGrid.hpp"
+#include "SweepAndPrune.hpp"
+
+namespace Fizz {
+	Nutella::Ref<BroadPhase> BroadPhase::Create(BroadPhaseType type) {
+		switch (type) {
+		case BroadPhaseType::QUADTREE:
+			return Nutella::CreateRef<QuadtreeBroadPhase>();
+
+		case BroadPhaseType::DYNAMIC_TREE:
+			return Nutella::CreateRef<DynamicAABBTree>();
+
+		case BroadPhaseType::SPATIAL_HASH:
+			return Nutella::CreateRef<SpatialHashGrid>();
+
+		case BroadPhaseType::SWEEP_AND_PRUNE:
+			return Nutella::CreateRef<SweepAndPrune>();
+
+		default:
+			NT_ASSERT(false, "Unrecognized broad phase type!");
+			return nullptr;
+		}
+	}
+} // namespace Fizz
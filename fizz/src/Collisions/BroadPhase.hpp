@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+
+#include "Objects/BodyStore.hpp"
+
+namespace Fizz {
+	/** List of pairs of bodies that may be colliding, identified by their IDs in the body store */
+	using CollisionList = std::vector<std::pair<BodyID, BodyID>>;
+
+	/** The strategies available for broad phase collision detection */
+	enum class BroadPhaseType { QUADTREE = 0, DYNAMIC_TREE, SPATIAL_HASH, SWEEP_AND_PRUNE, COUNT };
+
+	/** Interface for broad phase collision detection filters. A broad phase cheaply rules out
+	 *  pairs of objects that cannot possibly be colliding, so that the (expensive) narrow phase
+	 *  only has to examine the pairs that remain.
+	 *
+	 *  Broad phases may keep state between updates, and are told when objects leave the
+	 *  environment so that this state can be cleaned up.
+	 */
+	class BroadPhase {
+	  public:
+		virtual ~BroadPhase() = default;
+
+		/** Finds all pairs of bodies whose bounding boxes intersect. Each intersecting pair is
+		 *  reported exactly once.
+		 *
+		 *  @param bodies: Every body in the environment
+		 *  @param possibleCollisions: Output list of pairs that may be colliding. Cleared before
+		 *  any pairs are added.
+		 */
+		virtual void FindPossibleCollisions(const BodyStore& bodies,
+											CollisionList& possibleCollisions) = 0;
+
+		/** Finds every body whose bounding box may intersect the given box. Bodies are tested
+		 *  where the last call to FindPossibleCollisions saw them.
+		 *
+		 *  @param bounds: The box to test against
+		 *  @param bodies: Output list of the IDs of bodies that may intersect the box. Cleared
+		 *  before any IDs are added.
+		 */
+		virtual void Query(const AABB& bounds, std::vector<BodyID>& bodies) = 0;
+
+		/** Notifies the broad phase that a body has been removed from the environment. Its ID may
+		 *  be reused by a body created afterwards.
+		 *
+		 *  @param id: The ID of the body being removed
+		 */
+		virtual void Remove(BodyID id) = 0;
+
+		/** Gets the strategy this broad phase implements */
+		virtual BroadPhaseType GetType() const = 0;
+
+		/** Creates a broad phase implementing the given strategy.
+		 *
+		 *  @param type: The strategy to use
+		 *
+		 *  @return The new broad phase
+		 */
+		static Nutella::Ref<BroadPhase> Create(BroadPhaseType type);
+	};
+} // namespace Fizz
@@ -10,10 +10,15 @@ namespace Fizz {
 	/** Calculates the normal of the simplex pointed towards the origin */
 	glm::vec2 NextDir(const Simplex<Support>& s);
 
-	bool GJKColliding(Nutella::Ref<PhysicsObject>& p1, Nutella::Ref<PhysicsObject>& p2) {
+	bool GJKColliding(const Nutella::Ref<PhysicsObject>& p1,
+					  const Nutella::Ref<PhysicsObject>& p2) {
+		return GJKColliding(*p1->GetShape(), *p2->GetShape(), p2->GetPos() - p1->GetPos());
+	}
+
+	bool GJKColliding(const Shape& p1, const Shape& p2, const glm::vec2& initialDir) {
 		NT_PROFILE_FUNC();
 
-		glm::vec2 nextDir = p2->GetPos() - p1->GetPos();
+		glm::vec2 nextDir = initialDir;
 		if (nextDir == glm::vec2(0.0f, 0.0f)) {
 			nextDir = glm::vec2(1.0f, 0.0f);
 		}
@@ -22,6 +27,10 @@ namespace Fizz {
 		Support supportPoint(MinkowskiDiffSupport(p1, p2, nextDir));
 		Simplex<Support> s({supportPoint});
 		nextDir = -supportPoint.mkSupport;
+		if (nextDir == glm::vec2(0.0f, 0.0f)) {
+			// shapes touch at exactly this point, but do not overlap
+			return false;
+		}
 
 		// add second point to simplex
 		supportPoint = MinkowskiDiffSupport(p1, p2, nextDir);
@@ -93,16 +102,25 @@ namespace Fizz {
 		return dir;
 	}
 
+	/** Maximum number of points added to the simplex while measuring the distance between two
+	 *  shapes. The closest edge found by then is used.
+	 */
+	static const uint32_t MAX_DISTANCE_ITERATIONS = 64;
+
+	/** Maximum number of points in the polytope expanded by EPA. If EPA has not converged by the
+	 *  time the polytope is full, the closest edge found so far is used.
+	 */
+	static const uint32_t MAX_POLYTOPE_POINTS = 32;
+	using Polytope = Simplex<Support, MAX_POLYTOPE_POINTS>;
+
 	/** Finds the closest point to the origin on the line segment defined by two points */
-	glm::vec2 Line(const Simplex<Support>& s) {
+	glm::vec2 Line(const Support& a, const Support& b) {
 		// TEMP: consider a way of doing this that is less senstive to fp errors
-		NT_ASSERT(s.Size() == 2, "Invalid Simplex during collision detection!");
-
-		if (s[0].mkSupport == s[1].mkSupport)
-			return s[0].mkSupport;
+		if (a.mkSupport == b.mkSupport)
+			return a.mkSupport;
 
-		glm::vec2 AB = s[1].mkSupport - s[0].mkSupport;
-		glm::vec2 AO = -s[0].mkSupport;
+		glm::vec2 AB = b.mkSupport - a.mkSupport;
+		glm::vec2 AO = -a.mkSupport;
 
 		// AB * AO =  length of projection of AO onto AB times length of AB
 		// AB * AB = length of AB^2
@@ -112,7 +130,7 @@ namespace Fizz {
 
 		// P = A + t * AB gives all of AB component of AO
 		// therefore, PO is perpendicular to AB, meaning it is the closest to the origin
-		return s[0].mkSupport + t * AB;
+		return a.mkSupport + t * AB;
 	}
 
 	/** Finds the closest point to the origin on the triangle defined by three points. Also removes
@@ -135,8 +153,8 @@ namespace Fizz {
 
 		if (proj1 > 0 && proj2 > 0) {
 			// either line from s[2] could be closest, we must check
-			glm::vec2 p1 = Line(Simplex<Support>({s[0], s[2]}));
-			glm::vec2 p2 = Line(Simplex<Support>({s[1], s[2]}));
+			glm::vec2 p1 = Line(s[0], s[2]);
+			glm::vec2 p2 = Line(s[1], s[2]);
 
 			if (glm::dot(p1, p1) > glm::dot(p2, p2)) {
 				// line using s[1] is closer
@@ -150,17 +168,17 @@ namespace Fizz {
 		} else if (proj1 > 0) {
 			// origin is in region 2
 			s.Remove(0);
-			return Line(s);
+			return Line(s[0], s[1]);
 		} else if (proj2 > 0) {
 			// origin is in region 3
 			s.Remove(1);
-			return Line(s);
+			return Line(s[0], s[1]);
 		} else if (glm::dot(norm1, norm1) < glm::pow(10, -8)) {
 			// triangle is really a line, can only happen if we have already reached the termination
 			// condition (i.e. support has moved perpendicularly to direction of origin, therefore,
 			// no progress was made)
 			s.Remove(2);
-			return Line(Simplex<Support>({s[0], s[1]}));
+			return Line(s[0], s[1]);
 		}
 
 		// Otherwise, origin is in simplex -> collision
@@ -168,30 +186,55 @@ namespace Fizz {
 	}
 
 	/** Finds the distance between the two objects. Returns the direction and magnitude of the
-	 *  shortest vector from any point on p1 to any point on p2.
+	 *  shortest vector from any point on p1 to any point on p2. Starts from a simplex of two or
+	 *  three points. Objects that only touch (the origin lies on the simplex) are reported as
+	 *  separated by a distance of 0.
 	 */
-	Collision GJKDistance(Nutella::Ref<PhysicsObject>& p1, Nutella::Ref<PhysicsObject>& p2,
-						  Simplex<Support>& s, float tolerance);
+	Collision GJKDistance(const Shape& p1, const Shape& p2, Simplex<Support>& s, float tolerance);
 
 	/** Calculates a point on p1 and p2 such that the distance between these points is the shortest
 	 * distance from any point on p1 to any point on p2. Uses the final simplex created by
 	 * GJKDistance as an input to do this.
 	 */
-	std::pair<glm::vec2, glm::vec2> ComputeWitnessPoints(Nutella::Ref<PhysicsObject>& p1,
-														 Nutella::Ref<PhysicsObject>& p2,
+	std::pair<glm::vec2, glm::vec2> ComputeWitnessPoints(const Shape& p1, const Shape& p2,
 														 Simplex<Support>& s);
 
 	/** Finds the closest point on the edge of the Minkowski difference to the origin, and
 	 * returns the collision this point describes.
 	 */
-	Collision EPA(Nutella::Ref<PhysicsObject>& p1, Nutella::Ref<PhysicsObject>& p2,
-				  Simplex<Support>& s, float tolerance);
+	Collision EPA(const Shape& p1, const Shape& p2, const Simplex<Support>& simplex,
+				  float tolerance);
 
-	Collision GJKGetCollision(Nutella::Ref<PhysicsObject>& p1, Nutella::Ref<PhysicsObject>& p2,
+	Collision GJKGetCollision(const Nutella::Ref<PhysicsObject>& p1,
+							  const Nutella::Ref<PhysicsObject>& p2,
+							  float tolerance /* = glm::pow(10, -5)*/) {
+		Collision collision = GJKGetCollision(*p1->GetShape(), *p2->GetShape(),
+											  p2->GetPos() - p1->GetPos(), tolerance);
+		collision.collider = p1->GetID();
+		collision.collided = p2->GetID();
+
+		return collision;
+	}
+
+	Collision GJKGetCollision(const BodyStore& bodies, BodyID id1, BodyID id2,
+							  float tolerance /* = glm::pow(10, -5)*/) {
+		uint32_t i1 = bodies.GetIndex(id1);
+		uint32_t i2 = bodies.GetIndex(id2);
+
+		Collision collision =
+			GJKGetCollision(*bodies.GetShape(i1), *bodies.GetShape(i2),
+							bodies.GetPosition(i2) - bodies.GetPosition(i1), tolerance);
+		collision.collider = id1;
+		collision.collided = id2;
+
+		return collision;
+	}
+
+	Collision GJKGetCollision(const Shape& p1, const Shape& p2, const glm::vec2& initialDir,
 							  float tolerance /* = glm::pow(10, -5)*/) {
 		NT_PROFILE_FUNC();
 
-		glm::vec2 nextDir = p2->GetPos() - p1->GetPos();
+		glm::vec2 nextDir = initialDir;
 		if (nextDir == glm::vec2(0.0f, 0.0f)) {
 			nextDir = glm::vec2(1.0f, 0.0f);
 		}
@@ -199,6 +242,13 @@ namespace Fizz {
 		// add first point to simplex
 		Support supportPoint(MinkowskiDiffSupport(p1, p2, nextDir));
 		Simplex<Support> s({supportPoint});
+
+		if (supportPoint.mkSupport == glm::vec2(0.0f, 0.0f)) {
+			// the shapes touch at exactly this point, which leaves no direction to search in
+			// bodies are filled in by the caller
+			return {0, 0, false, 0.0f, glm::normalize(nextDir), supportPoint.p1Support,
+					supportPoint.p2Support};
+		}
 		nextDir = -supportPoint.mkSupport;
 
 		// add second point to simplex
@@ -216,7 +266,6 @@ namespace Fizz {
 			s.Add(supportPoint);
 			if (glm::dot(nextDir, supportPoint.mkSupport) < 0) {
 				// simplex cannot possibly contain origin
-				Triangle(s);
 				return GJKDistance(p1, p2, s, tolerance);
 			}
 
@@ -234,41 +283,120 @@ namespace Fizz {
 		return EPA(p1, p2, s, tolerance);
 	}
 
-	Collision GJKDistance(Nutella::Ref<PhysicsObject>& p1, Nutella::Ref<PhysicsObject>& p2,
-						  Simplex<Support>& s, float tolerance) {
+	bool GJKCachedSeparation(const Shape& p1, const Shape& p2, const GJKCache& cache,
+							 Collision& collision) {
+		if (cache.axis == glm::vec2(0.0f, 0.0f))
+			return false;
+
+		// p1 - p2 has no points past the origin along the axis -> the shapes are still separated
+		glm::vec2 axis = glm::normalize(cache.axis);
+		Support support = MinkowskiDiffSupport(p1, p2, axis);
+		float gap = -glm::dot(axis, support.mkSupport);
+		if (gap <= 0.0f)
+			return false;
+
+		// bodies are filled in by the caller
+		collision = {0, 0, false, gap, axis, support.p1Support, support.p2Support};
+		return true;
+	}
+
+	Collision GJKGetCollision(const Shape& p1, const Shape& p2, GJKCache& cache,
+							  const glm::vec2& initialDir,
+							  float tolerance /* = glm::pow(10, -5)*/) {
 		NT_PROFILE_FUNC();
 
-		glm::vec2 nextDir = -Line(s);
-		// check went here
+		Collision collision;
+		if (GJKCachedSeparation(p1, p2, cache, collision))
+			return collision;
 
-		while (true) {
+		// the last axis points roughly from p1 towards p2, or along the deepest penetration
+		glm::vec2 searchDir = cache.axis == glm::vec2(0.0f, 0.0f) ? initialDir : cache.axis;
+		collision = GJKGetCollision(p1, p2, searchDir, tolerance);
+
+		// MTV and closestDir share storage, both point from p1 towards p2
+		cache.axis = collision.MTV;
+		return collision;
+	}
+
+	Collision GJKDistance(const Shape& p1, const Shape& p2, Simplex<Support>& s, float tolerance) {
+		NT_PROFILE_FUNC();
+
+		NT_ASSERT(s.Size() == 2 || s.Size() == 3, "Invalid Simplex during collision detection!");
+		glm::vec2 closest = s.Size() == 3 ? Triangle(s) : Line(s[0], s[1]);
+
+		// direction to report if the shapes turn out to touch, where the closest point gives none
+		glm::vec2 segment = s[1].mkSupport - s[0].mkSupport;
+		glm::vec2 touchDir(1.0f, 0.0f);
+		if (segment != glm::vec2(0.0f, 0.0f))
+			touchDir = glm::normalize(glm::vec2(-segment.y, segment.x));
+
+		for (uint32_t iteration = 0;; iteration++) {
+			// the origin is on or inside the simplex -> the shapes touch. Stop here, since there
+			// is no direction to search in, and no room in the simplex for another point.
+			if (s.Size() == 3 || closest == glm::vec2(0.0f, 0.0f)) {
+				auto [w1, w2] = ComputeWitnessPoints(p1, p2, s);
+
+				// bodies are filled in by the caller
+				return {0, 0, false, 0.0f, touchDir, w1, w2};
+			}
+
+			glm::vec2 nextDir = -closest;
+			touchDir = glm::normalize(nextDir);
 			s.Add(MinkowskiDiffSupport(p1, p2, nextDir));
 
 			// check if we are no longer making significant progress
 			float newSupportProj = glm::dot(nextDir, s[2].mkSupport);
 			float oldSupportProj = glm::dot(nextDir, s[1].mkSupport);
 
-			if (newSupportProj - oldSupportProj < tolerance) {
+			// rounding can keep the simplex cycling between nearly equal edges when the tolerance
+			// is finer than float precision, so the number of steps is capped too
+			if (newSupportProj - oldSupportProj < tolerance ||
+				iteration + 1 == MAX_DISTANCE_ITERATIONS) {
 				// error is less than tolerance -> return current distance
 				float separationDist = glm::length(nextDir);
-				glm::vec2 closestDir = nextDir / separationDist;
 
+				// shapes that only graze each other can leave the origin on the new triangle's
+				// edge; the previous closest segment is still accurate to within tolerance
 				Triangle(s);
+				if (s.Size() == 3)
+					s.Remove(2u);
 				auto [w1, w2] = ComputeWitnessPoints(p1, p2, s);
-				// glm::vec2 w1, w2;
 
-				return {p1, p2, false, separationDist, closestDir, w1, w2};
+				// bodies are filled in by the caller
+				return {0, 0, false, separationDist, touchDir, w1, w2};
 			}
 
 			// find next direction to search in, update simplex
-			nextDir = -Triangle(s);
+			closest = Triangle(s);
 		}
 	}
 
-	std::pair<glm::vec2, glm::vec2> ComputeWitnessPoints(Nutella::Ref<PhysicsObject>& p1,
-														 Nutella::Ref<PhysicsObject>& p2,
+	std::pair<glm::vec2, glm::vec2> ComputeWitnessPoints(const Shape& p1, const Shape& p2,
 														 Simplex<Support>& s) {
-		NT_ASSERT(s.Size() == 2, "Invalid Simplex during collision detection!");
+		NT_ASSERT(s.Size() == 2 || s.Size() == 3, "Invalid Simplex during collision detection!");
+
+		if (s.Size() == 3) {
+			// origin is inside the triangle -> weight each point by the area of the triangle the
+			// origin makes with the other two (barycentric coordinates)
+			const glm::vec2& a = s[0].mkSupport;
+			const glm::vec2& b = s[1].mkSupport;
+			const glm::vec2& c = s[2].mkSupport;
+			float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+
+			if (area != 0.0f) {
+				float weightA = (b.x * c.y - b.y * c.x) / area;
+				float weightB = (c.x * a.y - c.y * a.x) / area;
+				float weightC = 1.0f - weightA - weightB;
+
+				return {weightA * s[0].p1Support + weightB * s[1].p1Support +
+							weightC * s[2].p1Support,
+						weightA * s[0].p2Support + weightB * s[1].p2Support +
+							weightC * s[2].p2Support};
+			}
+
+			// flat triangle -> fall back to its first edge
+			s.Remove(2u);
+		}
 
 		glm::vec2 p1a = s[0].p1Support;
 		glm::vec2 p1b = s[1].p1Support;
@@ -290,8 +418,12 @@ namespace Fizz {
 		return {closest1, closest2};
 	}
 
-	Collision EPA(Nutella::Ref<PhysicsObject>& p1, Nutella::Ref<PhysicsObject>& p2,
-				  Simplex<Support>& s, float tolerance) {
+	Collision EPA(const Shape& p1, const Shape& p2, const Simplex<Support>& simplex,
+				  float tolerance) {
+		Polytope s;
+		for (const Support& point : simplex)
+			s.Add(point);
+
 		while (true) {
 			float closestDist = glm::dot(s[0].mkSupport, s[0].mkSupport);
 			glm::vec2 closestDir(s[0].mkSupport);
@@ -301,7 +433,7 @@ namespace Fizz {
 			for (uint32_t i = 0; i < s.Size(); i++) {
 				uint32_t j = i + 1 == s.Size() ? 0 : i + 1;
 
-				glm::vec2 p = Line(Simplex<Support>({s[i], s[j]}));
+				glm::vec2 p = Line(s[i], s[j]);
 				float newDist = glm::dot(p, p);
 
 				if (newDist < closestDist) {
@@ -315,6 +447,16 @@ namespace Fizz {
 			if (closestDist < glm::pow(10, -15)) {
 				// origin is on edge of simplex -> need to search along edge normals
 				glm::vec2 edge = s[closestIdx % s.Size()].mkSupport - s[closestIdx - 1].mkSupport;
+
+				// shapes that only touch can give repeated points, and so edges with no normal;
+				// take the next edge round that has one
+				for (uint32_t k = 1; edge == glm::vec2(0.0f, 0.0f) && k < s.Size(); k++) {
+					edge = s[(closestIdx + k) % s.Size()].mkSupport -
+						   s[(closestIdx + k - 1) % s.Size()].mkSupport;
+				}
+				if (edge == glm::vec2(0.0f, 0.0f))
+					edge = glm::vec2(0.0f, 1.0f);
+
 				glm::vec2 norm(-edge.y, edge.x);
 
 				// make sure we are searching away from rest of simplex
@@ -327,11 +469,14 @@ namespace Fizz {
 
 			Support nextPoint = MinkowskiDiffSupport(p1, p2, closestDir);
 
-			// check if we are still making significant progress
+			// check if we are still making significant progress. closestDir is not normalized, so
+			// divide the gain by its length; otherwise shallow overlaps stop short of their depth
 			float oldDist = closestDist;
 			float newDist = glm::dot(nextPoint.mkSupport, closestDir);
+			float progress =
+				(newDist - oldDist) * glm::inversesqrt(glm::dot(closestDir, closestDir));
 
-			if (newDist - oldDist < tolerance) {
+			if (progress < tolerance || s.IsFull()) {
 				float penetrationDepth;
 				glm::vec2 MTV;
 
@@ -345,7 +490,8 @@ namespace Fizz {
 					MTV = closestDir / penetrationDepth;
 				}
 
-				return {p1, p2, true, penetrationDepth, MTV};
+				// bodies are filled in by the caller
+				return {0, 0, true, penetrationDepth, MTV};
 			} else {
 				s.Add(nextPoint, closestIdx);
 			}
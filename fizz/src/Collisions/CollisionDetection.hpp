@@ -4,14 +4,28 @@
 #include <Nutella.hpp>
 
 #include "Objects/PhysicsObject.hpp"
+#include "Objects/BodyStore.hpp"
 
 namespace Fizz {
+	/** A point where two overlapping objects touch. */
+	struct ContactPoint {
+		/** Position of the contact in world space, halfway between the two surfaces */
+		glm::vec2 position;
+		/** How far the objects overlap at this point, along the collision normal */
+		float penetration;
+		/** Identifies the features (vertices or edges) of each object that produced this point.
+		 *  Contact points with the same ID in consecutive updates describe the same contact.
+		 */
+		uint32_t id;
+	};
+
 	/** Structure describing the collision (if any) between two objects. If there is a collision,
 	 *  this structure will contain information about how the objects are colliding. Otherwise, it
 	 *  will contain information about the distance between the two objects.
 	 */
 	struct Collision {
-		Nutella::Ref<PhysicsObject> collider, collided;
+		/* IDs of the colliding bodies in the body store of their environment */
+		BodyID collider, collided;
 
 		/* Whether or not there actually is a collision between collider and collided. */
 		bool exists;
@@ -47,6 +61,13 @@ namespace Fizz {
 		glm::vec2 witness1;
 		/** Witness point on p2. i.e. the closest point on p2 to any point on p1. */
 		glm::vec2 witness2;
+
+		/** Contact manifold; the points where the objects touch. Set if the collision exists,
+		 *  and the shape pair has a contact routine (see GetCollision). Collisions found by EPA
+		 *  alone have no contact points.
+		 */
+		ContactPoint contacts[2];
+		uint32_t numContacts;
 	};
 
 	struct Support {
@@ -59,25 +80,34 @@ namespace Fizz {
 	 *  the Minkowski difference p1 - p2 (i.e. the point on p1 - p2 with the largest dot product
 	 *  with the given direction).
 	 *
-	 *  @param p1: The first physics object
-	 *  @param p2: The second physics object (subtracted from p1)
+	 *  @param p1: The first shape
+	 *  @param p2: The second shape (subtracted from p1)
 	 *  @param dir: The direction to get the support point in
 	 *
-	 *  @return The farthest point on p1 - p2 in the given direction, and the points on each body
+	 *  @return The farthest point on p1 - p2 in the given direction, and the points on each shape
 	 * used to make it
 	 */
-	inline Support MinkowskiDiffSupport(const Nutella::Ref<PhysicsObject>& p1,
-										const Nutella::Ref<PhysicsObject>& p2,
-										const glm::vec2& dir) {
+	inline Support MinkowskiDiffSupport(const Shape& p1, const Shape& p2, const glm::vec2& dir) {
 		NT_PROFILE_FUNC();
 
-		glm::vec2 p1s = p1->GetShape()->Support(dir);
-		glm::vec2 p2s = p2->GetShape()->Support(-dir);
+		glm::vec2 p1s = p1.Support(dir);
+		glm::vec2 p2s = p2.Support(-dir);
 		glm::vec2 finalSupport = p1s - p2s;
 
 		return {finalSupport, p1s, p2s};
 	}
 
+	/** Results of GJK kept between updates for a pair of shapes, so that the next query can start
+	 *  where the last one ended. A default constructed cache is empty.
+	 */
+	struct GJKCache {
+		/** Direction from the first shape towards the second found by the last query: the
+		 *  closest direction if the shapes were apart, or the MTV if they were colliding. Zero if
+		 *  there was no last query.
+		 */
+		glm::vec2 axis = glm::vec2(0.0f, 0.0f);
+	};
+
 	/** Tests whether two physics bodies are colliding.
 	 *
 	 *	This should be used if the only information desired is whether or not the given bodies
@@ -88,7 +118,17 @@ namespace Fizz {
 	 *  @param p2: The second physics object
 	 *  @return true if the objects are colliding, false otherwise
 	 */
-	bool GJKColliding(Nutella::Ref<PhysicsObject>& p1, Nutella::Ref<PhysicsObject>& p2);
+	bool GJKColliding(const Nutella::Ref<PhysicsObject>& p1, const Nutella::Ref<PhysicsObject>& p2);
+
+	/** Tests whether two shapes are colliding. See GJKColliding for physics objects.
+	 *
+	 *  @param p1: The first shape
+	 *  @param p2: The second shape
+	 *  @param initialDir: The direction to start searching in. Converges fastest if this points
+	 *  roughly from p1 towards p2.
+	 *  @return true if the shapes are colliding, false otherwise
+	 */
+	bool GJKColliding(const Shape& p1, const Shape& p2, const glm::vec2& initialDir);
 
 	/** Creates a structure describing the collision (if any) between the given objects. The
 	 *  returned structure has a boolean value indicating whether the two objects were actually
@@ -110,7 +150,73 @@ namespace Fizz {
 	 *
 	 *  @return Details about the collision between p1 and p2
 	 */
-	Collision GJKGetCollision(Nutella::Ref<PhysicsObject>& p1, Nutella::Ref<PhysicsObject>& p2,
+	Collision GJKGetCollision(const Nutella::Ref<PhysicsObject>& p1,
+							  const Nutella::Ref<PhysicsObject>& p2,
 							  float tolerance = glm::pow(10, -5));
 
+	/** Creates a structure describing the collision (if any) between two bodies in a body store.
+	 *  See GJKGetCollision for physics objects.
+	 *
+	 *  @param bodies: The body store holding both bodies
+	 *  @param id1: The ID of the first body
+	 *  @param id2: The ID of the second body
+	 *  @param tolerance: The acceptable error in the returned measurement (determines exit
+	 *  condition)
+	 *
+	 *  @return Details about the collision between the bodies
+	 */
+	Collision GJKGetCollision(const BodyStore& bodies, BodyID id1, BodyID id2,
+							  float tolerance = glm::pow(10, -5));
+
+	/** Creates a structure describing the collision (if any) between two shapes. The collider and
+	 *  collided IDs of the result are left for the caller to fill in.
+	 *
+	 *  @param p1: The first shape
+	 *  @param p2: The second shape
+	 *  @param initialDir: The direction to start searching in. Converges fastest if this points
+	 *  roughly from p1 towards p2.
+	 *  @param tolerance: The acceptable error in the returned measurement (determines exit
+	 *  condition)
+	 *
+	 *  @return Details about the collision between p1 and p2
+	 */
+	Collision GJKGetCollision(const Shape& p1, const Shape& p2, const glm::vec2& initialDir,
+							  float tolerance = glm::pow(10, -5));
+
+	/** Creates a structure describing the collision (if any) between two shapes, warm started
+	 *  from the last query on the same pair. Meant for pairs that are checked every update, whose
+	 *  relative position changes little in between.
+	 *
+	 *  If the axis found by the last query still separates the shapes, the query stops there,
+	 *  and the separation distance and closest direction are measured along that axis. In this
+	 *  case the distance is only a lower bound, and the witness points are the points of each
+	 *  shape furthest along the axis rather than the closest points. Otherwise, GJK starts
+	 *  searching along the cached axis. Either way, the cache is updated for the next query.
+	 *
+	 *  @param p1: The first shape
+	 *  @param p2: The second shape
+	 *  @param cache: State from the last query on this pair of shapes
+	 *  @param initialDir: The direction to start searching in if the cache is empty
+	 *  @param tolerance: The acceptable error in the returned measurement (determines exit
+	 *  condition)
+	 *
+	 *  @return Details about the collision between p1 and p2
+	 */
+	Collision GJKGetCollision(const Shape& p1, const Shape& p2, GJKCache& cache,
+							  const glm::vec2& initialDir, float tolerance = glm::pow(10, -5));
+
+	/** Checks whether the axis cached for a pair of shapes still separates them. See
+	 *  GJKGetCollision with a cache for the meaning of the result.
+	 *
+	 *  @param p1: The first shape
+	 *  @param p2: The second shape
+	 *  @param cache: State from the last query on this pair of shapes
+	 *  @param collision: Set to the separation along the cached axis if it still separates the
+	 *  shapes. Left untouched otherwise.
+	 *
+	 *  @return true if the shapes are still separated along the cached axis, false otherwise
+	 */
+	bool GJKCachedSeparation(const Shape& p1, const Shape& p2, const GJKCache& cache,
+							 Collision& collision);
+
 } // namespace Fizz
@@ -0,0 +1,672 @@
+#include "CollisionDispatch.hpp"
+
+#include <cfloat>
+#include <utility>
+
+namespace Fizz {
+	/** Swaps the roles of the two shapes in a collision */
+	static inline Collision Flip(Collision collision) {
+		// MTV and closestDir share storage, both point from collider to collided
+		collision.MTV = -collision.MTV;
+		std::swap(collision.witness1, collision.witness2);
+		return collision;
+	}
+
+	/** Builds the collision between two shapes given the closest (or deepest) points on each of
+	 *  them, and the signed distance between the shapes along the given normal. Overlapping shapes
+	 *  get a single contact point between the witness points.
+	 */
+	static inline Collision MakeCollision(float distance, const glm::vec2& normal,
+										  const glm::vec2& witness1, const glm::vec2& witness2) {
+		// bodies are filled in by the caller
+		if (distance > 0.0f)
+			return {0, 0, false, distance, normal, witness1, witness2};
+
+		Collision collision = {0, 0, true, -distance, normal, witness1, witness2};
+		collision.contacts[0] = {(witness1 + witness2) / 2.0f, -distance, 0};
+		collision.numContacts = 1;
+		return collision;
+	}
+
+	/** Packs the features of each polygon that produced a contact point into a contact ID. Each
+	 *  polygon gets 16 bits: the index of its feature in the low 15, and the feature's type in the
+	 *  top bit, so polygons may have up to MAX_FEATURE_INDEX + 1 vertices.
+	 */
+	enum class FeatureType : uint8_t { VERTEX = 0, EDGE };
+	static const uint32_t MAX_FEATURE_INDEX = 0x7FFF;
+	static inline uint32_t ContactID(uint32_t indexA, FeatureType typeA, uint32_t indexB,
+									 FeatureType typeB) {
+		NT_ASSERT(indexA <= MAX_FEATURE_INDEX && indexB <= MAX_FEATURE_INDEX,
+				  "Polygon has too many vertices for a contact ID!");
+		return indexA | (uint32_t) typeA << 15 | indexB << 16 | (uint32_t) typeB << 31;
+	}
+
+	/** Swaps the roles of the two polygons in a contact ID */
+	static inline uint32_t FlipContactID(uint32_t id) { return id << 16 | id >> 16; }
+
+	Collision CircleCircleCollision(const Circle& c1, const Circle& c2) {
+		NT_PROFILE_FUNC();
+
+		glm::vec2 between = c2.GetPosition() - c1.GetPosition();
+		float centerDistSqr = glm::dot(between, between);
+
+		// concentric circles have no preferred direction, pick one
+		glm::vec2 normal(1.0f, 0.0f);
+		float centerDist = 0.0f;
+		if (centerDistSqr > 0.0f) {
+			centerDist = glm::sqrt(centerDistSqr);
+			normal = between / centerDist;
+		}
+
+		return MakeCollision(centerDist - c1.GetRadius() - c2.GetRadius(), normal,
+							 c1.GetPosition() + c1.GetRadius() * normal,
+							 c2.GetPosition() - c2.GetRadius() * normal);
+	}
+
+	Collision CirclePolygonCollision(const Circle& circle, const Polygon& polygon) {
+		NT_PROFILE_FUNC();
+
+		const glm::vec2& center = circle.GetPosition();
+		const std::vector<glm::vec2>& points = polygon.GetTransformedPoints();
+		uint32_t numPoints = points.size();
+
+		// find the edge the center is furthest in front of, and the point on the boundary closest
+		// to the center
+		float maxSeparation = -FLT_MAX;
+		glm::vec2 maxSeparationNormal(1.0f, 0.0f);
+		float closestDistSqr = FLT_MAX;
+		glm::vec2 closest = points[0];
+
+		for (uint32_t i = 0; i < numPoints; i++) {
+			const glm::vec2& a = points[i];
+			const glm::vec2& b = points[i + 1 == numPoints ? 0 : i + 1];
+			glm::vec2 edge = b - a;
+			float edgeLengthSqr = glm::dot(edge, edge);
+			if (edgeLengthSqr == 0.0f)
+				continue;
+
+			// outward normal, given counter-clockwise winding
+			glm::vec2 normal = glm::vec2(edge.y, -edge.x) * glm::inversesqrt(edgeLengthSqr);
+			float separation = glm::dot(center - a, normal);
+			if (separation > maxSeparation) {
+				maxSeparation = separation;
+				maxSeparationNormal = normal;
+			}
+
+			float t = glm::clamp(glm::dot(center - a, edge) / edgeLengthSqr, 0.0f, 1.0f);
+			glm::vec2 point = a + t * edge;
+			glm::vec2 toCenter = center - point;
+			float distSqr = glm::dot(toCenter, toCenter);
+			if (distSqr < closestDistSqr) {
+				closestDistSqr = distSqr;
+				closest = point;
+			}
+		}
+
+		// normal pointing from the polygon to the circle, and signed distance between the center
+		// and the polygon
+		glm::vec2 normal;
+		float centerDist;
+		if (maxSeparation <= 0.0f) {
+			// center is inside the polygon -> push out through the nearest edge
+			normal = maxSeparationNormal;
+			centerDist = maxSeparation;
+			closest = center - maxSeparation * normal;
+		} else {
+			centerDist = glm::sqrt(closestDistSqr);
+			normal = centerDist > 0.0f ? (center - closest) / centerDist : maxSeparationNormal;
+		}
+
+		return MakeCollision(centerDist - circle.GetRadius(), -normal,
+							 center - circle.GetRadius() * normal, closest);
+	}
+
+	/** Gets the outward normal of the edge from a to b, given counter-clockwise winding */
+	static inline glm::vec2 EdgeNormal(const glm::vec2& a, const glm::vec2& b) {
+		glm::vec2 edge = b - a;
+		return glm::vec2(edge.y, -edge.x) * glm::inversesqrt(glm::dot(edge, edge));
+	}
+
+	/** Finds the edge of polygon a that polygon b is furthest in front of, and how far in front of
+	 *  it b is. A positive separation means the polygons do not overlap. A segment counts as a
+	 *  polygon with two edges, one facing each way.
+	 */
+	static float FindMaxSeparation(const glm::vec2* a, uint32_t numA, const glm::vec2* b,
+								   uint32_t numB, uint32_t& edgeIndex) {
+		float maxSeparation = -FLT_MAX;
+		edgeIndex = 0;
+
+		for (uint32_t i = 0; i < numA; i++) {
+			const glm::vec2& v1 = a[i];
+			glm::vec2 normal = EdgeNormal(v1, a[i + 1 == numA ? 0 : i + 1]);
+
+			// deepest point of b along the normal
+			float separation = FLT_MAX;
+			for (uint32_t j = 0; j < numB; j++)
+				separation = glm::min(separation, glm::dot(normal, b[j] - v1));
+
+			if (separation > maxSeparation) {
+				maxSeparation = separation;
+				edgeIndex = i;
+			}
+		}
+
+		return maxSeparation;
+	}
+
+	struct ClipVertex {
+		glm::vec2 position;
+		uint32_t id;
+	};
+
+	/** Clips a segment of the incident polygon to the half plane dot(normal, x) <= offset. Points
+	 *  generated by clipping are identified by the clipping plane's vertex on the reference
+	 *  polygon and the incident edge.
+	 *
+	 *  @return The number of points left in out (0 to 2)
+	 */
+	static uint32_t ClipSegment(ClipVertex out[2], const ClipVertex in[2], const glm::vec2& normal,
+								float offset, uint32_t planeVertex, uint32_t incidentEdge) {
+		uint32_t numOut = 0;
+
+		float dist0 = glm::dot(normal, in[0].position) - offset;
+		float dist1 = glm::dot(normal, in[1].position) - offset;
+
+		// vertices just outside the plane are kept as they are, so that a vertex lying on the
+		// plane (e.g. the corners of two boxes of the same width stacked on each other) keeps
+		// the same ID whichever way it is rounded
+		const float clipTolerance = 0.0005f;
+		bool inside0 = dist0 <= clipTolerance;
+		bool inside1 = dist1 <= clipTolerance;
+
+		if (inside0)
+			out[numOut++] = in[0];
+		if (inside1)
+			out[numOut++] = in[1];
+
+		// points are on opposite sides of the plane -> add the intersection. A point kept by the
+		// tolerance is not crossed, so the interpolation never reaches outside the segment
+		if (inside0 != inside1 && dist0 * dist1 < 0.0f) {
+			float t = dist0 / (dist0 - dist1);
+			out[numOut].position = in[0].position + t * (in[1].position - in[0].position);
+			out[numOut].id = ContactID(planeVertex, FeatureType::VERTEX, incidentEdge,
+									   FeatureType::EDGE);
+			numOut++;
+		}
+
+		return numOut;
+	}
+
+	/** Finds the collision between two shapes with GJK, warm started from the cache if there is
+	 *  one. Used where a faster routine cannot handle a pair.
+	 */
+	static Collision GJKFallback(const Shape& p1, const Shape& p2, GJKCache* cache,
+								 const glm::vec2& initialDir, float tolerance) {
+		if (!cache)
+			return GJKGetCollision(p1, p2, initialDir, tolerance);
+
+		return GJKGetCollision(p1, p2, *cache, initialDir, tolerance);
+	}
+
+	/** Finds the collision between two polygons, see PolygonPolygonCollision. The cache may be
+	 *  null.
+	 */
+	static Collision SATCollision(const Polygon& p1, const Polygon& p2, GJKCache* cache,
+								  const glm::vec2& initialDir, float tolerance) {
+		NT_PROFILE_FUNC();
+
+		// most pairs found by the broad phase are still apart along the last separating axis
+		Collision collision;
+		if (cache && GJKCachedSeparation(p1, p2, *cache, collision))
+			return collision;
+
+		const std::vector<glm::vec2>& points1 = p1.GetTransformedPoints();
+		const std::vector<glm::vec2>& points2 = p2.GetTransformedPoints();
+
+		// separated polygons need an exact distance, which SAT does not give
+		uint32_t edge1, edge2;
+		float separation1 = FindMaxSeparation(points1.data(), points1.size(), points2.data(),
+											  points2.size(), edge1);
+		if (separation1 > 0.0f)
+			return GJKFallback(p1, p2, cache, initialDir, tolerance);
+
+		float separation2 = FindMaxSeparation(points2.data(), points2.size(), points1.data(),
+											  points1.size(), edge2);
+		if (separation2 > 0.0f)
+			return GJKFallback(p1, p2, cache, initialDir, tolerance);
+
+		// the reference face is the face of least penetration. Prefer p1 unless p2 is clearly
+		// better, so the choice does not flicker between nearly equal faces.
+		const float referenceTolerance = 0.0005f;
+		bool flip = separation2 > separation1 + referenceTolerance;
+		const std::vector<glm::vec2>& reference = flip ? points2 : points1;
+		const std::vector<glm::vec2>& incident = flip ? points1 : points2;
+		uint32_t referenceEdge = flip ? edge2 : edge1;
+
+		uint32_t refIdx1 = referenceEdge;
+		uint32_t refIdx2 = refIdx1 + 1 == reference.size() ? 0 : refIdx1 + 1;
+		const glm::vec2& v1 = reference[refIdx1];
+		const glm::vec2& v2 = reference[refIdx2];
+		glm::vec2 tangent = glm::normalize(v2 - v1);
+		glm::vec2 normal(tangent.y, -tangent.x);
+
+		// incident edge is the edge of the other polygon most anti-parallel to the reference face
+		uint32_t incidentEdge = 0;
+		float minDot = FLT_MAX;
+		for (uint32_t i = 0; i < incident.size(); i++) {
+			float dot =
+				glm::dot(normal, EdgeNormal(incident[i], incident[(i + 1) % incident.size()]));
+			if (dot < minDot) {
+				minDot = dot;
+				incidentEdge = i;
+			}
+		}
+
+		uint32_t incIdx1 = incidentEdge;
+		uint32_t incIdx2 = incIdx1 + 1 == incident.size() ? 0 : incIdx1 + 1;
+		ClipVertex incidentPoints[2] = {
+			{incident[incIdx1],
+			 ContactID(refIdx1, FeatureType::EDGE, incIdx1, FeatureType::VERTEX)},
+			{incident[incIdx2],
+			 ContactID(refIdx1, FeatureType::EDGE, incIdx2, FeatureType::VERTEX)},
+		};
+
+		// clip the incident edge to the sides of the reference face
+		ClipVertex clipped1[2], clipped2[2];
+		if (ClipSegment(clipped1, incidentPoints, -tangent, -glm::dot(tangent, v1), refIdx1,
+						incidentEdge) < 2)
+			return GJKFallback(p1, p2, cache, initialDir, tolerance);
+		if (ClipSegment(clipped2, clipped1, tangent, glm::dot(tangent, v2), refIdx2,
+						incidentEdge) < 2)
+			return GJKFallback(p1, p2, cache, initialDir, tolerance);
+
+		// keep points behind the reference face
+		collision = {0, 0, true, -(flip ? separation2 : separation1),
+							   flip ? -normal : normal};
+		collision.numContacts = 0;
+
+		float frontOffset = glm::dot(normal, v1);
+		float maxPenetration = -FLT_MAX;
+		for (const ClipVertex& point : clipped2) {
+			float separation = glm::dot(normal, point.position) - frontOffset;
+			if (separation > 0.0f)
+				continue;
+
+			// deepest point gives the witness points
+			glm::vec2 onReference = point.position - separation * normal;
+			if (-separation > maxPenetration) {
+				maxPenetration = -separation;
+				collision.witness1 = flip ? point.position : onReference;
+				collision.witness2 = flip ? onReference : point.position;
+			}
+
+			ContactPoint& contact = collision.contacts[collision.numContacts++];
+			contact.position = (point.position + onReference) / 2.0f;
+			contact.penetration = -separation;
+			contact.id = flip ? FlipContactID(point.id) : point.id;
+		}
+
+		if (collision.numContacts == 0)
+			return GJKFallback(p1, p2, cache, initialDir, tolerance);
+
+		if (cache)
+			cache->axis = collision.MTV;
+
+		return collision;
+	}
+
+	Collision PolygonPolygonCollision(const Polygon& p1, const Polygon& p2,
+									  const glm::vec2& initialDir,
+									  float tolerance /* = glm::pow(10, -5)*/) {
+		return SATCollision(p1, p2, nullptr, initialDir, tolerance);
+	}
+
+	Collision PolygonPolygonCollision(const Polygon& p1, const Polygon& p2, GJKCache& cache,
+									  const glm::vec2& initialDir,
+									  float tolerance /* = glm::pow(10, -5)*/) {
+		return SATCollision(p1, p2, &cache, initialDir, tolerance);
+	}
+
+	/** A convex core of one or more points, grown outwards by a radius. A circle is a rounded
+	 *  point, a capsule a rounded segment, and a segment or polygon a hull with no rounding, so
+	 *  one routine can collide any pair of them.
+	 */
+	struct RoundedHull {
+		const glm::vec2* points;
+		uint32_t count;
+		float radius;
+	};
+
+	/** Gets the rounded hull of a shape. Segments with both ends in the same place have a single
+	 *  point, since they have no edge to take a normal from.
+	 */
+	static RoundedHull GetRoundedHull(const Shape& shape) {
+		switch (shape.GetType()) {
+		case ShapeType::CIRCLE: {
+			const Circle& circle = static_cast<const Circle&>(shape);
+			return {&circle.GetPosition(), 1, circle.GetRadius()};
+		}
+
+		case ShapeType::POLYGON: {
+			const std::vector<glm::vec2>& points =
+				static_cast<const Polygon&>(shape).GetTransformedPoints();
+			return {points.data(), (uint32_t) points.size(), 0.0f};
+		}
+
+		case ShapeType::CAPSULE: {
+			const Capsule& capsule = static_cast<const Capsule&>(shape);
+			uint32_t count = capsule.GetStart() == capsule.GetEnd() ? 1 : 2;
+			return {capsule.GetPoints(), count, capsule.GetRadius()};
+		}
+
+		case ShapeType::SEGMENT: {
+			const Segment& segment = static_cast<const Segment&>(shape);
+			uint32_t count = segment.GetStart() == segment.GetEnd() ? 1 : 2;
+			return {segment.GetPoints(), count, 0.0f};
+		}
+
+		default:
+			NT_ASSERT(false, "Unrecognized Shape type!");
+			return {nullptr, 0, 0.0f};
+		}
+	}
+
+	/** Gets the outward normal of an edge of a rounded hull's core */
+	static inline glm::vec2 HullEdgeNormal(const RoundedHull& hull, uint32_t edge) {
+		return EdgeNormal(hull.points[edge], hull.points[edge + 1 == hull.count ? 0 : edge + 1]);
+	}
+
+	/** Finds the closest points between the segments p1 to q1 and p2 to q2, and how far along
+	 *  each segment they are (0 at p, 1 at q). Either segment may be a single point.
+	 *
+	 *  @return The squared distance between the closest points
+	 */
+	static float ClosestPoints(const glm::vec2& p1, const glm::vec2& q1, const glm::vec2& p2,
+							   const glm::vec2& q2, float& s, float& t, glm::vec2& c1,
+							   glm::vec2& c2) {
+		glm::vec2 d1 = q1 - p1;
+		glm::vec2 d2 = q2 - p2;
+		glm::vec2 r = p1 - p2;
+		float lengthSqr1 = glm::dot(d1, d1);
+		float lengthSqr2 = glm::dot(d2, d2);
+		float f = glm::dot(d2, r);
+
+		if (lengthSqr1 == 0.0f && lengthSqr2 == 0.0f) {
+			s = t = 0.0f;
+		} else if (lengthSqr1 == 0.0f) {
+			s = 0.0f;
+			t = glm::clamp(f / lengthSqr2, 0.0f, 1.0f);
+		} else {
+			float c = glm::dot(d1, r);
+			if (lengthSqr2 == 0.0f) {
+				t = 0.0f;
+				s = glm::clamp(-c / lengthSqr1, 0.0f, 1.0f);
+			} else {
+				// closest points of the infinite lines, then clamped to each segment in turn.
+				// Parallel lines have no single closest pair, so start from p1.
+				float b = glm::dot(d1, d2);
+				float denom = lengthSqr1 * lengthSqr2 - b * b;
+				s = denom != 0.0f ? glm::clamp((b * f - c * lengthSqr2) / denom, 0.0f, 1.0f) : 0.0f;
+				t = (b * s + f) / lengthSqr2;
+
+				if (t < 0.0f) {
+					t = 0.0f;
+					s = glm::clamp(-c / lengthSqr1, 0.0f, 1.0f);
+				} else if (t > 1.0f) {
+					t = 1.0f;
+					s = glm::clamp((b - c) / lengthSqr1, 0.0f, 1.0f);
+				}
+			}
+		}
+
+		c1 = p1 + s * d1;
+		c2 = p2 + t * d2;
+		glm::vec2 between = c2 - c1;
+		return glm::dot(between, between);
+	}
+
+	/** Finds the collision between two shapes by treating each as a rounded hull. Used for every
+	 *  pair involving a capsule or segment.
+	 *
+	 *  Cores that are apart are measured exactly from their closest points, found edge by edge.
+	 *  If the radii close the gap, and the closest points are the ends of both edges (corners
+	 *  touching), the shapes touch at a single point between them. Otherwise, the shapes are
+	 *  resting face to face (or their cores overlap), and get up to two contact points by
+	 *  clipping, like a pair of polygons, with each point's depth reduced by the radii.
+	 */
+	static Collision RoundedHullCollision(const Shape& p1, const Shape& p2, GJKCache* cache,
+										  const glm::vec2& initialDir, float tolerance) {
+		NT_PROFILE_FUNC();
+
+		RoundedHull a = GetRoundedHull(p1);
+		RoundedHull b = GetRoundedHull(p2);
+		float radius = a.radius + b.radius;
+
+		// separating axis test on the cores. A single point has no edges to test.
+		uint32_t edgeA = 0, edgeB = 0;
+		float separationA = a.count >= 2
+								? FindMaxSeparation(a.points, a.count, b.points, b.count, edgeA)
+								: -FLT_MAX;
+		float separationB = b.count >= 2
+								? FindMaxSeparation(b.points, b.count, a.points, a.count, edgeB)
+								: -FLT_MAX;
+
+		// prefer a's face unless b's is clearly better, as for polygons
+		const float referenceTolerance = 0.0005f;
+		bool flip = separationB > separationA + referenceTolerance;
+
+		// a point inside a polygon's core has no closest points to measure from; it is pushed out
+		// through the polygon's nearest face instead
+		if (a.count == 1 && b.count >= 3 && separationB < 0.0f) {
+			glm::vec2 face = HullEdgeNormal(b, edgeB);
+			return MakeCollision(separationB - radius, -face, a.points[0] - a.radius * face,
+								 a.points[0] - (separationB - b.radius) * face);
+		}
+		if (b.count == 1 && a.count >= 3 && separationA < 0.0f) {
+			glm::vec2 face = HullEdgeNormal(a, edgeA);
+			return MakeCollision(separationA - radius, face,
+								 b.points[0] - (separationA - a.radius) * face,
+								 b.points[0] - b.radius * face);
+		}
+
+		// any other point lies outside the other core, or on a segment (which has no inside), so
+		// points are always measured from their closest points
+		if (a.count == 1 || b.count == 1 || glm::max(separationA, separationB) > 0.0f) {
+			// segments and points have a single edge; polygons one per vertex
+			uint32_t numEdgesA = a.count < 3 ? 1 : a.count;
+			uint32_t numEdgesB = b.count < 3 ? 1 : b.count;
+
+			float distSqr = FLT_MAX;
+			float s = 0.0f, t = 0.0f;
+			glm::vec2 closestA(0.0f), closestB(0.0f);
+			for (uint32_t i = 0; i < numEdgesA; i++) {
+				const glm::vec2& startA = a.points[i];
+				const glm::vec2& endA = a.points[i + 1 == a.count ? 0 : i + 1];
+
+				for (uint32_t j = 0; j < numEdgesB; j++) {
+					const glm::vec2& startB = b.points[j];
+					const glm::vec2& endB = b.points[j + 1 == b.count ? 0 : j + 1];
+
+					float edgeS, edgeT;
+					glm::vec2 edgeClosestA, edgeClosestB;
+					float edgeDistSqr = ClosestPoints(startA, endA, startB, endB, edgeS, edgeT,
+													  edgeClosestA, edgeClosestB);
+					if (edgeDistSqr < distSqr) {
+						distSqr = edgeDistSqr;
+						s = edgeS;
+						t = edgeT;
+						closestA = edgeClosestA;
+						closestB = edgeClosestB;
+					}
+				}
+			}
+
+			float dist = glm::sqrt(distSqr);
+			bool cornerA = a.count == 1 || s == 0.0f || s == 1.0f;
+			bool cornerB = b.count == 1 || t == 0.0f || t == 1.0f;
+			if (dist > radius || (cornerA && cornerB) || a.count == 1 || b.count == 1) {
+				// touching cores give no direction, so take the best separating axis instead
+				glm::vec2 normal(1.0f, 0.0f);
+				if (dist > 0.0f)
+					normal = (closestB - closestA) / dist;
+				else if (flip)
+					normal = -HullEdgeNormal(b, edgeB);
+				else if (a.count >= 2)
+					normal = HullEdgeNormal(a, edgeA);
+
+				return MakeCollision(dist - radius, normal, closestA + a.radius * normal,
+									 closestB - b.radius * normal);
+			}
+		}
+
+		const RoundedHull& reference = flip ? b : a;
+		const RoundedHull& incident = flip ? a : b;
+		uint32_t refIdx1 = flip ? edgeB : edgeA;
+		uint32_t refIdx2 = refIdx1 + 1 == reference.count ? 0 : refIdx1 + 1;
+		const glm::vec2& v1 = reference.points[refIdx1];
+		const glm::vec2& v2 = reference.points[refIdx2];
+		glm::vec2 tangent = glm::normalize(v2 - v1);
+		glm::vec2 normal(tangent.y, -tangent.x);
+
+		// incident edge is the edge of the other core most anti-parallel to the reference face
+		uint32_t incidentEdge = 0;
+		float minDot = FLT_MAX;
+		for (uint32_t i = 0; i < incident.count; i++) {
+			float dot = glm::dot(normal, HullEdgeNormal(incident, i));
+			if (dot < minDot) {
+				minDot = dot;
+				incidentEdge = i;
+			}
+		}
+
+		uint32_t incIdx1 = incidentEdge;
+		uint32_t incIdx2 = incIdx1 + 1 == incident.count ? 0 : incIdx1 + 1;
+		ClipVertex incidentPoints[2] = {
+			{incident.points[incIdx1],
+			 ContactID(refIdx1, FeatureType::EDGE, incIdx1, FeatureType::VERTEX)},
+			{incident.points[incIdx2],
+			 ContactID(refIdx1, FeatureType::EDGE, incIdx2, FeatureType::VERTEX)},
+		};
+
+		// clip the incident edge to the sides of the reference face
+		ClipVertex clipped1[2], clipped2[2];
+		if (ClipSegment(clipped1, incidentPoints, -tangent, -glm::dot(tangent, v1), refIdx1,
+						incidentEdge) < 2)
+			return GJKFallback(p1, p2, cache, initialDir, tolerance);
+		if (ClipSegment(clipped2, clipped1, tangent, glm::dot(tangent, v2), refIdx2,
+						incidentEdge) < 2)
+			return GJKFallback(p1, p2, cache, initialDir, tolerance);
+
+		// keep points the radii reach past the reference face
+		Collision collision = {0, 0, true, radius - (flip ? separationB : separationA),
+							   flip ? -normal : normal};
+		collision.numContacts = 0;
+
+		float frontOffset = glm::dot(normal, v1);
+		float maxPenetration = -FLT_MAX;
+		for (const ClipVertex& point : clipped2) {
+			float separation = glm::dot(normal, point.position) - frontOffset;
+			if (separation > radius)
+				continue;
+
+			// the point moved out to the surface of each shape
+			glm::vec2 onReference = point.position - (separation - reference.radius) * normal;
+			glm::vec2 onIncident = point.position - incident.radius * normal;
+
+			// deepest point gives the witness points
+			float penetration = radius - separation;
+			if (penetration > maxPenetration) {
+				maxPenetration = penetration;
+				collision.witness1 = flip ? onIncident : onReference;
+				collision.witness2 = flip ? onReference : onIncident;
+			}
+
+			ContactPoint& contact = collision.contacts[collision.numContacts++];
+			contact.position = (onIncident + onReference) / 2.0f;
+			contact.penetration = penetration;
+			contact.id = flip ? FlipContactID(point.id) : point.id;
+		}
+
+		if (collision.numContacts == 0)
+			return GJKFallback(p1, p2, cache, initialDir, tolerance);
+
+		return collision;
+	}
+
+	// kernels that can be warm started take a cache, which may be null
+	using CollisionKernel = Collision (*)(const Shape& p1, const Shape& p2, GJKCache* cache,
+										  const glm::vec2& initialDir, float tolerance);
+
+	static Collision CircleCircleKernel(const Shape& p1, const Shape& p2, GJKCache*,
+										const glm::vec2&, float) {
+		return CircleCircleCollision(static_cast<const Circle&>(p1),
+									 static_cast<const Circle&>(p2));
+	}
+
+	static Collision CirclePolygonKernel(const Shape& p1, const Shape& p2, GJKCache*,
+										 const glm::vec2&, float) {
+		return CirclePolygonCollision(static_cast<const Circle&>(p1),
+									  static_cast<const Polygon&>(p2));
+	}
+
+	static Collision PolygonCircleKernel(const Shape& p1, const Shape& p2, GJKCache*,
+										 const glm::vec2&, float) {
+		return Flip(CirclePolygonCollision(static_cast<const Circle&>(p2),
+										   static_cast<const Polygon&>(p1)));
+	}
+
+	static Collision PolygonPolygonKernel(const Shape& p1, const Shape& p2, GJKCache* cache,
+										  const glm::vec2& initialDir, float tolerance) {
+		return SATCollision(static_cast<const Polygon&>(p1), static_cast<const Polygon&>(p2),
+							cache, initialDir, tolerance);
+	}
+
+	static_assert((int) ShapeType::COUNT == 4, "Collision kernel table is out of date!");
+
+	// kernel for each pair of shape types, indexed [first shape][second shape]
+	static const CollisionKernel s_CollisionKernels[(int) ShapeType::COUNT]
+												   [(int) ShapeType::COUNT] = {
+		/* CIRCLE  */ {CircleCircleKernel, CirclePolygonKernel, RoundedHullCollision,
+					   RoundedHullCollision},
+		/* POLYGON */ {PolygonCircleKernel, PolygonPolygonKernel, RoundedHullCollision,
+					   RoundedHullCollision},
+		/* CAPSULE */ {RoundedHullCollision, RoundedHullCollision, RoundedHullCollision,
+					   RoundedHullCollision},
+		/* SEGMENT */ {RoundedHullCollision, RoundedHullCollision, RoundedHullCollision,
+					   RoundedHullCollision},
+	};
+
+	Collision GetCollision(const Shape& p1, const Shape& p2, const glm::vec2& initialDir,
+						   float tolerance /* = glm::pow(10, -5)*/) {
+		CollisionKernel kernel = s_CollisionKernels[(int) p1.GetType()][(int) p2.GetType()];
+		return kernel(p1, p2, nullptr, initialDir, tolerance);
+	}
+
+	/** Finds the collision between two bodies, see GetCollision. The cache may be null. */
+	static Collision GetBodyCollision(const BodyStore& bodies, BodyID id1, BodyID id2,
+									  GJKCache* cache, float tolerance) {
+		uint32_t i1 = bodies.GetIndex(id1);
+		uint32_t i2 = bodies.GetIndex(id2);
+
+		const Shape& p1 = *bodies.GetShape(i1);
+		const Shape& p2 = *bodies.GetShape(i2);
+		CollisionKernel kernel = s_CollisionKernels[(int) p1.GetType()][(int) p2.GetType()];
+
+		Collision collision = kernel(p1, p2, cache,
+									 bodies.GetPosition(i2) - bodies.GetPosition(i1), tolerance);
+		collision.collider = id1;
+		collision.collided = id2;
+
+		return collision;
+	}
+
+	Collision GetCollision(const BodyStore& bodies, BodyID id1, BodyID id2,
+						   float tolerance /* = glm::pow(10, -5)*/) {
+		return GetBodyCollision(bodies, id1, id2, nullptr, tolerance);
+	}
+
+	Collision GetCollision(const BodyStore& bodies, BodyID id1, BodyID id2, GJKCache& cache,
+						   float tolerance /* = glm::pow(10, -5)*/) {
+		return GetBodyCollision(bodies, id1, id2, &cache, tolerance);
+	}
+} // namespace Fizz
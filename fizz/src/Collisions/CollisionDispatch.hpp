@@ -0,0 +1,111 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <Nutella.hpp>
+
+#include "Objects/BodyStore.hpp"
+#include "Objects/Capsule.hpp"
+#include "Objects/Circle.hpp"
+#include "Objects/Polygon.hpp"
+#include "Objects/Segment.hpp"
+#include "CollisionDetection.hpp"
+
+namespace Fizz {
+	/** Creates a structure describing the collision (if any) between two shapes, using the
+	 *  cheapest routine available for their types. Pairs involving a circle are solved in closed
+	 *  form, and overlapping polygons by the separating axis test. Pairs involving a capsule or
+	 *  segment are solved on the shapes' cores (the segment inside a capsule, the center of a
+	 *  circle), with the separating axis test or the closest points between edges, and then
+	 *  grown by the radii.
+	 *
+	 *  The result has the same meaning as the result of GJKGetCollision, and the collider and
+	 *  collided IDs are likewise left for the caller to fill in.
+	 *
+	 *  @param p1: The first shape
+	 *  @param p2: The second shape
+	 *  @param initialDir: The direction GJK should start searching in, if it is used
+	 *  @param tolerance: The acceptable error in the returned measurement, if GJK is used
+	 *
+	 *  @return Details about the collision between p1 and p2
+	 */
+	Collision GetCollision(const Shape& p1, const Shape& p2, const glm::vec2& initialDir,
+						   float tolerance = glm::pow(10, -5));
+
+	/** Creates a structure describing the collision (if any) between two bodies in a body store.
+	 *  See GetCollision for shapes.
+	 *
+	 *  @param bodies: The body store holding both bodies
+	 *  @param id1: The ID of the first body
+	 *  @param id2: The ID of the second body
+	 *  @param tolerance: The acceptable error in the returned measurement, if GJK is used
+	 *
+	 *  @return Details about the collision between the bodies
+	 */
+	Collision GetCollision(const BodyStore& bodies, BodyID id1, BodyID id2,
+						   float tolerance = glm::pow(10, -5));
+
+	/** Creates a structure describing the collision (if any) between two bodies, warm started
+	 *  from the last query on the same pair. Pairs that were separated last time are first
+	 *  checked against their old separating axis; see GJKGetCollision with a cache for how this
+	 *  changes the result for pairs that are still apart. Pairs solved in closed form ignore the
+	 *  cache.
+	 *
+	 *  @param bodies: The body store holding both bodies
+	 *  @param id1: The ID of the first body
+	 *  @param id2: The ID of the second body
+	 *  @param cache: State from the last query on this pair of bodies. Updated for the next one.
+	 *  @param tolerance: The acceptable error in the returned measurement, if GJK is used
+	 *
+	 *  @return Details about the collision between the bodies
+	 */
+	Collision GetCollision(const BodyStore& bodies, BodyID id1, BodyID id2, GJKCache& cache,
+						   float tolerance = glm::pow(10, -5));
+
+	/** Finds the collision (if any) between two circles in closed form.
+	 *
+	 *  @param c1: The first circle
+	 *  @param c2: The second circle
+	 *
+	 *  @return Details about the collision between c1 and c2, with witness points set whether or
+	 *  not they are colliding
+	 */
+	Collision CircleCircleCollision(const Circle& c1, const Circle& c2);
+
+	/** Finds the collision (if any) between a circle and a convex polygon in closed form, from
+	 *  the point on the polygon closest to the circle's center.
+	 *
+	 *  @param circle: The circle (first shape)
+	 *  @param polygon: The polygon (second shape). Must have counter-clockwise winding.
+	 *
+	 *  @return Details about the collision between circle and polygon, with witness points set
+	 *  whether or not they are colliding
+	 */
+	Collision CirclePolygonCollision(const Circle& circle, const Polygon& polygon);
+
+	/** Finds the collision (if any) between two convex polygons. Overlapping polygons are found by
+	 *  the separating axis test, and get a contact manifold of up to two points made by clipping
+	 *  the incident edge of one polygon against the reference (least penetrated) edge of the
+	 *  other. Each contact is tagged with the features that produced it, so a solver can match
+	 *  contacts between updates. Separated polygons, and degenerate cases clipping cannot handle,
+	 *  fall back to GJK.
+	 *
+	 *  @param p1: The first polygon. Must have counter-clockwise winding.
+	 *  @param p2: The second polygon. Must have counter-clockwise winding.
+	 *  @param initialDir: The direction GJK should start searching in, if it is used
+	 *  @param tolerance: The acceptable error in the returned measurement, if GJK is used
+	 *
+	 *  @return Details about the collision between p1 and p2
+	 */
+	Collision PolygonPolygonCollision(const Polygon& p1, const Polygon& p2,
+									  const glm::vec2& initialDir,
+									  float tolerance = glm::pow(10, -5));
+
+	/** Same as above, except warm started from the last query on the same pair of polygons. See
+	 *  GJKGetCollision with a cache.
+	 *
+	 *  @param cache: State from the last query on this pair of polygons. Updated for the next one.
+	 */
+	Collision PolygonPolygonCollision(const Polygon& p1, const Polygon& p2, GJKCache& cache,
+									  const glm::vec2& initialDir,
+									  float tolerance = glm::pow(10, -5));
+} // namespace Fizz
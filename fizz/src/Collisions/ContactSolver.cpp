@@ -0,0 +1,391 @@
+#include "ContactSolver.hpp"
+
+#include <Nutella.hpp>
+
+namespace Fizz {
+	// fraction of the remaining penetration removed by each position iteration
+	static const float POSITION_CORRECTION = 0.2f;
+	// penetration allowed before it is corrected, so resting contacts stay touching
+	static const float PENETRATION_SLOP = 0.01f;
+	// largest distance a contact is corrected by at once, so deep overlaps are pushed apart
+	// gradually rather than ejected
+	static const float MAX_CORRECTION = 0.2f;
+	// closing speed below which contacts do not bounce, so resting bodies come to rest
+	static const float RESTITUTION_THRESHOLD = 0.5f;
+	// number of collisions handed to a thread at once when solving a batch
+	static const uint32_t SOLVER_GRAIN_SIZE = 64;
+	// largest condition number of a two point manifold's mass matrix that is still solved as a
+	// block. Beyond this the points are nearly the same, and are solved one at a time.
+	static const float MAX_BLOCK_CONDITION = 1000.0f;
+
+	/** Gets the z component of the cross product of two vectors in the plane */
+	static inline float Cross(const glm::vec2& a, const glm::vec2& b) {
+		return a.x * b.y - a.y * b.x;
+	}
+
+	/** Gets the velocity of a point at offset r from the center of a body spinning at w */
+	static inline glm::vec2 Cross(float w, const glm::vec2& r) { return {-w * r.y, w * r.x}; }
+
+	/** Gets the velocity of a point on a body, relative to the world */
+	static inline glm::vec2 PointVelocity(const BodyStore& bodies, uint32_t index,
+										  const glm::vec2& r) {
+		return bodies.GetVelocity(index) + Cross(bodies.GetAngularVelocity(index), r);
+	}
+
+	ContactSolver::ContactSolver(uint32_t velocityIterations, uint32_t positionIterations)
+		: m_VelocityIterations(velocityIterations), m_PositionIterations(positionIterations) {}
+	ContactSolver::~ContactSolver() {}
+
+	void ContactSolver::Solve(BodyStore& bodies, const std::vector<Collision>& collisions,
+							  const std::vector<PairState*>& states, float ts, JobSystem& jobs) {
+		NT_PROFILE_FUNC();
+		NT_ASSERT(collisions.size() == states.size(), "Every collision needs a pair state!");
+
+		Color(bodies, collisions);
+
+		// constraints are built in color order, so each batch is a contiguous run of them
+		m_Constraints.clear();
+		m_FirstConstraints.clear();
+		m_Blocks.clear();
+
+		for (uint32_t collision : m_Order) {
+			m_FirstConstraints.push_back(m_Constraints.size());
+			Prepare(bodies, collisions[collision], *states[collision]);
+		}
+		m_FirstConstraints.push_back(m_Constraints.size());
+
+		// bounce velocities must be measured before any impulse is applied, so warm starting
+		// waits until every constraint has been built
+		ForEachBatch(jobs, [&](uint32_t begin, uint32_t end) {
+			for (uint32_t c = m_FirstConstraints[begin]; c < m_FirstConstraints[end]; c++) {
+				const Constraint& constraint = m_Constraints[c];
+				glm::vec2 tangent = Cross(1.0f, constraint.normal);
+				ApplyImpulse(bodies, constraint,
+							 constraint.impulse * constraint.normal +
+								 constraint.tangentImpulse * tangent);
+			}
+		});
+
+		for (uint32_t iteration = 0; iteration < m_VelocityIterations; iteration++) {
+			ForEachBatch(jobs, [&](uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; i++)
+					SolveVelocity(bodies, i);
+			});
+		}
+
+		// penetration is removed by moving bodies directly, rather than by adding velocity,
+		// so that correcting an overlap never adds energy
+		for (Constraint& constraint : m_Constraints)
+			PreparePosition(bodies, constraint, ts);
+
+		for (uint32_t iteration = 0; iteration < m_PositionIterations; iteration++) {
+			ForEachBatch(jobs, [&](uint32_t begin, uint32_t end) {
+				for (uint32_t c = m_FirstConstraints[begin]; c < m_FirstConstraints[end]; c++)
+					SolvePosition(bodies, m_Constraints[c]);
+			});
+		}
+
+		// keep the impulses for the next update
+		for (uint32_t i = 0; i < m_Order.size(); i++) {
+			PairState& state = *states[m_Order[i]];
+			state.numImpulses = 0;
+
+			for (uint32_t c = m_FirstConstraints[i]; c < m_FirstConstraints[i + 1]; c++)
+				state.impulses[state.numImpulses++] = {
+					m_Constraints[c].id, m_Constraints[c].impulse, m_Constraints[c].tangentImpulse};
+		}
+	}
+
+	void ContactSolver::Color(const BodyStore& bodies, const std::vector<Collision>& collisions) {
+		NT_PROFILE_FUNC();
+
+		m_BodyColors.assign(bodies.Size(), 0);
+		m_Colors.resize(collisions.size());
+		m_ColorStarts.assign(NUM_COLORS + 2, 0);
+
+		// greedy coloring: each collision takes the first color neither of its bodies has yet
+		for (uint32_t i = 0; i < collisions.size(); i++) {
+			uint32_t A = bodies.GetIndex(collisions[i].collider);
+			uint32_t B = bodies.GetIndex(collisions[i].collided);
+
+			// static bodies are never written to, so any number of contacts may share one
+			bool staticA = bodies.GetInvMass(A) == 0.0f;
+			bool staticB = bodies.GetInvMass(B) == 0.0f;
+
+			uint64_t used = (staticA ? 0 : m_BodyColors[A]) | (staticB ? 0 : m_BodyColors[B]);
+			uint32_t color = OVERFLOW_COLOR;
+			if (~used != 0) {
+				color = 0;
+				while (used & (uint64_t) 1 << color)
+					color++;
+
+				if (!staticA)
+					m_BodyColors[A] |= (uint64_t) 1 << color;
+				if (!staticB)
+					m_BodyColors[B] |= (uint64_t) 1 << color;
+			}
+
+			m_Colors[i] = color;
+			m_ColorStarts[color + 1]++;
+		}
+
+		// counting sort by color, keeping the collisions of each color in their original order
+		for (uint32_t color = 0; color < NUM_COLORS + 1; color++)
+			m_ColorStarts[color + 1] += m_ColorStarts[color];
+
+		m_Order.resize(collisions.size());
+		m_ColorNext.assign(m_ColorStarts.begin(), m_ColorStarts.end() - 1);
+		for (uint32_t i = 0; i < collisions.size(); i++)
+			m_Order[m_ColorNext[m_Colors[i]]++] = i;
+	}
+
+	void ContactSolver::ForEachBatch(JobSystem& jobs, const JobSystem::RangeTask& task) {
+		for (uint32_t color = 0; color < NUM_COLORS + 1; color++) {
+			uint32_t first = m_ColorStarts[color];
+			uint32_t count = m_ColorStarts[color + 1] - first;
+
+			// collisions in the overflow color may share bodies, and small batches are not worth
+			// handing out
+			if (color == OVERFLOW_COLOR || count <= SOLVER_GRAIN_SIZE ||
+				jobs.GetThreadCount() == 1) {
+				if (count > 0)
+					task(first, first + count);
+				continue;
+			}
+
+			jobs.Wait(jobs.ParallelFor(count, SOLVER_GRAIN_SIZE,
+									   [first, &task](uint32_t begin, uint32_t end) {
+										   task(first + begin, first + end);
+									   }));
+		}
+	}
+
+	void ContactSolver::Prepare(const BodyStore& bodies, const Collision& collision,
+								const PairState& state) {
+		NT_ASSERT(collision.exists, "Cannot solve a collision that does not exist!");
+
+		uint32_t A = bodies.GetIndex(collision.collider);
+		uint32_t B = bodies.GetIndex(collision.collided);
+
+		float invMassA = bodies.GetInvMass(A), invMassB = bodies.GetInvMass(B);
+		float invInertiaA = bodies.GetInvInertia(A), invInertiaB = bodies.GetInvInertia(B);
+
+		NormalBlock& block = m_Blocks.emplace_back();
+		block.enabled = false;
+		if (invMassA + invMassB == 0.0f)
+			return; // two static bodies
+
+		float restitution = glm::min(bodies.GetRestitution(A), bodies.GetRestitution(B));
+		float friction = glm::sqrt(bodies.GetFriction(A) * bodies.GetFriction(B));
+		glm::vec2 tangent = Cross(1.0f, collision.MTV);
+
+		// collisions without a manifold are treated as one contact with the full depth
+		ContactPoint deepest = {(collision.witness1 + collision.witness2) / 2.0f,
+								collision.penetrationDepth, 0};
+		const ContactPoint* contacts = collision.numContacts ? collision.contacts : &deepest;
+		uint32_t numContacts = collision.numContacts ? collision.numContacts : 1;
+
+		for (uint32_t i = 0; i < numContacts; i++) {
+			const ContactPoint& contact = contacts[i];
+
+			Constraint constraint;
+			constraint.A = A;
+			constraint.B = B;
+			constraint.normal = collision.MTV;
+			constraint.rA = contact.position - bodies.GetPosition(A);
+			constraint.rB = contact.position - bodies.GetPosition(B);
+
+			// pushing off center spins a body as well as moving it, so it gives way more easily
+			float rnA = Cross(constraint.rA, constraint.normal);
+			float rnB = Cross(constraint.rB, constraint.normal);
+			constraint.normalMass = 1.0f / (invMassA + invMassB + invInertiaA * rnA * rnA +
+											invInertiaB * rnB * rnB);
+			float rtA = Cross(constraint.rA, tangent);
+			float rtB = Cross(constraint.rB, tangent);
+			constraint.tangentMass = 1.0f / (invMassA + invMassB + invInertiaA * rtA * rtA +
+											 invInertiaB * rtB * rtB);
+			constraint.friction = friction;
+
+			glm::vec2 vRel = PointVelocity(bodies, B, constraint.rB) -
+							 PointVelocity(bodies, A, constraint.rA);
+			float closingVel = glm::dot(vRel, constraint.normal);
+			constraint.bounceVel =
+				closingVel < -RESTITUTION_THRESHOLD ? -restitution * closingVel : 0.0f;
+
+			constraint.penetration = contact.penetration;
+			constraint.id = contact.id;
+
+			// warm start from the impulses applied to the same contact last update
+			constraint.impulse = 0.0f;
+			constraint.tangentImpulse = 0.0f;
+			for (uint32_t j = 0; j < state.numImpulses; j++) {
+				if (state.impulses[j].id == contact.id) {
+					constraint.impulse = state.impulses[j].normalImpulse;
+					constraint.tangentImpulse = state.impulses[j].tangentImpulse;
+					break;
+				}
+			}
+
+			m_Constraints.push_back(constraint);
+		}
+
+		// the normals of a two point manifold are solved together, so that resting bodies
+		// are held up evenly at both points rather than rocked from one to the other
+		if (numContacts == 2) {
+			const Constraint& c1 = m_Constraints[m_Constraints.size() - 2];
+			const Constraint& c2 = m_Constraints[m_Constraints.size() - 1];
+
+			float rn1A = Cross(c1.rA, c1.normal), rn1B = Cross(c1.rB, c1.normal);
+			float rn2A = Cross(c2.rA, c2.normal), rn2B = Cross(c2.rB, c2.normal);
+
+			float k11 = invMassA + invMassB + invInertiaA * rn1A * rn1A + invInertiaB * rn1B * rn1B;
+			float k22 = invMassA + invMassB + invInertiaA * rn2A * rn2A + invInertiaB * rn2B * rn2B;
+			float k12 = invMassA + invMassB + invInertiaA * rn1A * rn2A + invInertiaB * rn1B * rn2B;
+
+			float det = k11 * k22 - k12 * k12;
+			if (k11 * k11 < MAX_BLOCK_CONDITION * det) {
+				block.enabled = true;
+				block.K = glm::mat2(k11, k12, k12, k22);
+				block.normalMass = glm::inverse(block.K);
+			}
+		}
+	}
+
+	void ContactSolver::SolveVelocity(BodyStore& bodies, uint32_t collision) {
+		// friction first, so that the contacts are left not moving into each other
+		for (uint32_t c = m_FirstConstraints[collision]; c < m_FirstConstraints[collision + 1]; c++)
+			SolveFriction(bodies, m_Constraints[c]);
+
+		if (m_Blocks[collision].enabled) {
+			SolveNormalBlock(bodies, m_Blocks[collision],
+							 m_Constraints[m_FirstConstraints[collision]],
+							 m_Constraints[m_FirstConstraints[collision] + 1]);
+		} else {
+			for (uint32_t c = m_FirstConstraints[collision];
+				 c < m_FirstConstraints[collision + 1]; c++)
+				SolveNormal(bodies, m_Constraints[c]);
+		}
+	}
+
+	void ContactSolver::SolveFriction(BodyStore& bodies, Constraint& constraint) {
+		// impulse that stops the contact sliding, clamped to the friction cone of the normal
+		// impulse applied so far
+		glm::vec2 tangent = Cross(1.0f, constraint.normal);
+		glm::vec2 vRel = PointVelocity(bodies, constraint.B, constraint.rB) -
+						 PointVelocity(bodies, constraint.A, constraint.rA);
+		float tangentVel = glm::dot(vRel, tangent);
+
+		float maxFriction = constraint.friction * constraint.impulse;
+		float tangentImpulse = -constraint.tangentMass * tangentVel;
+		float totalTangent =
+			glm::clamp(constraint.tangentImpulse + tangentImpulse, -maxFriction, maxFriction);
+		tangentImpulse = totalTangent - constraint.tangentImpulse;
+		constraint.tangentImpulse = totalTangent;
+
+		ApplyImpulse(bodies, constraint, tangentImpulse * tangent);
+	}
+
+	void ContactSolver::SolveNormal(BodyStore& bodies, Constraint& constraint) {
+		glm::vec2 vRel = PointVelocity(bodies, constraint.B, constraint.rB) -
+						 PointVelocity(bodies, constraint.A, constraint.rA);
+		float normalVel = glm::dot(vRel, constraint.normal);
+
+		// impulse that brings the contact to its target velocity, clamped so that the total
+		// impulse only ever pushes the bodies apart
+		float impulse = constraint.normalMass * (constraint.bounceVel - normalVel);
+		float total = glm::max(constraint.impulse + impulse, 0.0f);
+		impulse = total - constraint.impulse;
+		constraint.impulse = total;
+
+		ApplyImpulse(bodies, constraint, impulse * constraint.normal);
+	}
+
+	void ContactSolver::SolveNormalBlock(BodyStore& bodies, const NormalBlock& block,
+										 Constraint& c1, Constraint& c2) {
+		// find the total impulses x >= 0 at both points such that each point either reaches its
+		// target velocity, or is separating with no impulse. This is a linear complementarity
+		// problem; with two points, every combination of active points can simply be tried.
+		glm::vec2 impulse(c1.impulse, c2.impulse);
+
+		auto normalVel = [&](const Constraint& c) {
+			glm::vec2 vRel = PointVelocity(bodies, c.B, c.rB) - PointVelocity(bodies, c.A, c.rA);
+			return glm::dot(vRel, c.normal) - c.bounceVel;
+		};
+
+		// velocity error each point would have with no impulse at all
+		glm::vec2 b = glm::vec2(normalVel(c1), normalVel(c2)) - block.K * impulse;
+
+		glm::vec2 total;
+		glm::vec2 x = -(block.normalMass * b);
+		if (x.x >= 0.0f && x.y >= 0.0f) {
+			total = x; // both points pushing
+		} else if (-c1.normalMass * b.x >= 0.0f &&
+				   block.K[0][1] * -c1.normalMass * b.x + b.y >= 0.0f) {
+			total = {-c1.normalMass * b.x, 0.0f}; // only the first point pushing
+		} else if (-c2.normalMass * b.y >= 0.0f &&
+				   block.K[1][0] * -c2.normalMass * b.y + b.x >= 0.0f) {
+			total = {0.0f, -c2.normalMass * b.y}; // only the second point pushing
+		} else if (b.x >= 0.0f && b.y >= 0.0f) {
+			total = {0.0f, 0.0f}; // both points separating
+		} else {
+			// no combination works, which only happens through rounding; leave the impulses
+			return;
+		}
+
+		glm::vec2 delta = total - impulse;
+		c1.impulse = total.x;
+		c2.impulse = total.y;
+		ApplyImpulse(bodies, c1, delta.x * c1.normal);
+		ApplyImpulse(bodies, c2, delta.y * c2.normal);
+	}
+
+	void ContactSolver::ApplyImpulse(BodyStore& bodies, const Constraint& constraint,
+									 const glm::vec2& P) {
+		// static bodies are shared between batches solved at the same time, so they must not be
+		// written to even though the change would be zero
+		if (float invMassA = bodies.GetInvMass(constraint.A)) {
+			float invInertiaA = bodies.GetInvInertia(constraint.A);
+			bodies.AddVelocity(constraint.A, -invMassA * P);
+			bodies.AddAngularVelocity(constraint.A, -invInertiaA * Cross(constraint.rA, P));
+		}
+		if (float invMassB = bodies.GetInvMass(constraint.B)) {
+			float invInertiaB = bodies.GetInvInertia(constraint.B);
+			bodies.AddVelocity(constraint.B, invMassB * P);
+			bodies.AddAngularVelocity(constraint.B, invInertiaB * Cross(constraint.rB, P));
+		}
+	}
+
+	void ContactSolver::PreparePosition(const BodyStore& bodies, Constraint& constraint,
+										float ts) {
+		// the bodies are about to move with their solved velocities; correct the penetration
+		// they will have afterwards
+		glm::vec2 vRel = PointVelocity(bodies, constraint.B, constraint.rB) -
+						 PointVelocity(bodies, constraint.A, constraint.rA);
+		constraint.penetration -= glm::dot(vRel, constraint.normal) * ts;
+
+		constraint.originA = bodies.GetPosition(constraint.A);
+		constraint.originB = bodies.GetPosition(constraint.B);
+	}
+
+	void ContactSolver::SolvePosition(BodyStore& bodies, const Constraint& constraint) {
+		// penetration left after the corrections made so far, including those made by other
+		// contacts on the same bodies
+		glm::vec2 movedA = bodies.GetPosition(constraint.A) - constraint.originA;
+		glm::vec2 movedB = bodies.GetPosition(constraint.B) - constraint.originB;
+		float penetration = constraint.penetration - glm::dot(movedB - movedA, constraint.normal);
+
+		float correction = POSITION_CORRECTION * (penetration - PENETRATION_SLOP);
+		correction = glm::clamp(correction, 0.0f, MAX_CORRECTION);
+		if (correction == 0.0f)
+			return;
+
+		// bodies are only pushed apart, not turned, so only their masses resist the correction
+		float invMassA = bodies.GetInvMass(constraint.A);
+		float invMassB = bodies.GetInvMass(constraint.B);
+		glm::vec2 P = correction / (invMassA + invMassB) * constraint.normal;
+		if (invMassA)
+			bodies.AddPosition(constraint.A, -invMassA * P);
+		if (invMassB)
+			bodies.AddPosition(constraint.B, invMassB * P);
+	}
+} // namespace Fizz
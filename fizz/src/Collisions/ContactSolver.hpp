@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Objects/BodyStore.hpp"
+#include "CollisionDetection.hpp"
+#include "PairCache.hpp"
+#include "Threading/JobSystem.hpp"
+
+namespace Fizz {
+	/* Iterative sequential impulse solver for contacts between bodies.
+
+	   Every contact point is a constraint that stops its bodies from moving further into each
+	   other, and resists them sliding along each other with Coulomb friction. Impulses act at the
+	   contact point, so contacts away from a body's center also change how fast it spins.
+	   Constraints are solved one at a time, each correcting the velocities left by the ones
+	   before it, and the whole set is swept several times so that the corrections settle across
+	   stacks of bodies. The two points of a face contact are solved together as one block, so
+	   the solver does not rock a body resting flat on another. The total impulse applied at each
+	   contact is kept (clamped so that contacts only ever push), and stored with the pair of
+	   bodies, so the next update can start from it rather than from rest.
+
+	   Once velocities are solved, any penetration the bodies would be left with is removed by a
+	   few sweeps that move the bodies apart directly. These sweeps only translate bodies;
+	   turning them as well feeds back into tall stacks and topples them.
+
+	   Collisions are split into batches by coloring the contact graph, so that no two
+	   collisions in a batch share a body that can move. Batches are solved one after another,
+	   and the collisions in each batch are solved in parallel without locks. The order
+	   constraints are solved in only depends on the collisions, so the result is the same for
+	   any number of threads.
+	 */
+	class ContactSolver {
+	  public:
+		/* Creates a solver.
+
+		   @param velocityIterations: The number of times every contact's velocity is solved
+		   per update
+		   @param positionIterations: The number of times every contact's penetration is
+		   corrected per update
+		 */
+		ContactSolver(uint32_t velocityIterations = 8, uint32_t positionIterations = 3);
+		~ContactSolver();
+
+		/* Solves the contacts of every collision, and stores the impulses applied for the next
+		   update. Must be called after the bodies' velocities are integrated, and before their
+		   positions are.
+
+		   @param bodies: The body store holding the colliding bodies
+		   @param collisions: Collisions to resolve. Must all exist.
+		   @param states: The cached state of each collision's pair, in the same order
+		   @param ts: The timestep being simulated
+		   @param jobs: The job system to solve batches of collisions on
+		 */
+		void Solve(BodyStore& bodies, const std::vector<Collision>& collisions,
+				   const std::vector<PairState*>& states, float ts, JobSystem& jobs);
+
+		inline uint32_t GetVelocityIterations() const { return m_VelocityIterations; }
+		inline void SetVelocityIterations(uint32_t iterations) {
+			m_VelocityIterations = iterations;
+		}
+
+		inline uint32_t GetPositionIterations() const { return m_PositionIterations; }
+		inline void SetPositionIterations(uint32_t iterations) {
+			m_PositionIterations = iterations;
+		}
+
+	  private:
+		struct Constraint {
+			// indices of the bodies in the body store
+			uint32_t A, B;
+
+			glm::vec2 normal;
+			// offsets of the contact point from the center of each body
+			glm::vec2 rA, rB;
+			// inverse of the effective mass of the bodies along the normal and the tangent, at
+			// the contact point
+			float normalMass, tangentMass;
+			// velocity the contact should separate at
+			float bounceVel;
+			float friction;
+			// total impulses applied so far
+			float impulse, tangentImpulse;
+
+			// penetration at the contact. Once velocities are solved, the penetration expected
+			// after the bodies move, measured from the bodies' positions at that point.
+			float penetration;
+			glm::vec2 originA, originB;
+
+			uint32_t id;
+		};
+
+		/* Assigns each collision a color, such that no two collisions of the same color share a
+		   non-static body, and orders the collisions by color */
+		void Color(const BodyStore& bodies, const std::vector<Collision>& collisions);
+
+		/* Runs a task over each batch of collisions in turn, splitting the batches across
+		   threads. The task is called as task(begin, end) with a range of positions in color
+		   order. */
+		void ForEachBatch(JobSystem& jobs, const JobSystem::RangeTask& task);
+
+		/* Builds the constraints for a collision, starting from the impulses cached for them */
+		void Prepare(const BodyStore& bodies, const Collision& collision,
+					 const PairState& state);
+
+		/* Effective mass of both normals of a two point manifold at once */
+		struct NormalBlock {
+			glm::mat2 K;
+			glm::mat2 normalMass; // inverse of K
+			// whether the manifold is solved as a block, rather than one point at a time
+			bool enabled;
+		};
+
+		/* Solves the velocities of the constraints of a collision, given the current body
+		   velocities
+
+		   @param collision: The position of the collision in color order */
+		void SolveVelocity(BodyStore& bodies, uint32_t collision);
+
+		/* Solves the friction of a single constraint */
+		void SolveFriction(BodyStore& bodies, Constraint& constraint);
+
+		/* Solves the normal velocity of a single constraint */
+		void SolveNormal(BodyStore& bodies, Constraint& constraint);
+
+		/* Solves the normal velocities of both constraints of a two point manifold at once */
+		void SolveNormalBlock(BodyStore& bodies, const NormalBlock& block, Constraint& c1,
+							  Constraint& c2);
+
+		/* Applies an impulse to both bodies of a constraint, at the contact point */
+		void ApplyImpulse(BodyStore& bodies, const Constraint& constraint, const glm::vec2& P);
+
+		/* Predicts the penetration of a constraint once its bodies move with their solved
+		   velocities */
+		void PreparePosition(const BodyStore& bodies, Constraint& constraint, float ts);
+
+		/* Moves the bodies of a single constraint apart, given their current positions */
+		void SolvePosition(BodyStore& bodies, const Constraint& constraint);
+
+	  private:
+		// colors available to the greedy coloring, one bit each in a body's mask. Collisions
+		// that find every color taken go in one more batch, which is solved serially.
+		static const uint32_t NUM_COLORS = 64;
+		static const uint32_t OVERFLOW_COLOR = NUM_COLORS;
+
+		uint32_t m_VelocityIterations;
+		uint32_t m_PositionIterations;
+
+		// constraints of every collision, ordered by color, and where each collision's
+		// constraints start. Reused between updates.
+		std::vector<Constraint> m_Constraints;
+		std::vector<uint32_t> m_FirstConstraints;
+		// normal block of each collision, ordered by color
+		std::vector<NormalBlock> m_Blocks;
+
+		// coloring state: colors used by each body, the color of each collision, the collisions
+		// ordered by color, where each color starts in that order, and where the next collision
+		// of each color goes while sorting
+		std::vector<uint64_t> m_BodyColors;
+		std::vector<uint32_t> m_Colors;
+		std::vector<uint32_t> m_Order;
+		std::vector<uint32_t> m_ColorStarts;
+		std::vector<uint32_t> m_ColorNext;
+	};
+} // namespace Fizz
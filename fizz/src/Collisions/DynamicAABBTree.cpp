@@ -0,0 +1,410 @@
+#include "DynamicAABBTree.hpp"
+
+#include <algorithm>
+
+namespace Fizz {
+	const int32_t DynamicAABBTree::NULL_NODE = -1;
+
+	/** Packs a pair of body IDs into a single key, smaller ID first */
+	static inline uint64_t PairKey(BodyID a, BodyID b) {
+		return a < b ? (uint64_t) a << 32 | b : (uint64_t) b << 32 | a;
+	}
+
+	DynamicAABBTree::DynamicAABBTree(float margin)
+		: m_Margin(margin), m_Root(NULL_NODE), m_FreeList(NULL_NODE) {}
+
+	DynamicAABBTree::~DynamicAABBTree() {}
+
+	void DynamicAABBTree::FindPossibleCollisions(const BodyStore& bodies,
+												 CollisionList& possibleCollisions) {
+		NT_PROFILE_FUNC();
+
+		// update leaves, reinserting those whose objects escaped their fat boxes
+		for (uint32_t i = 0; i < bodies.Size(); i++) {
+			BodyID id = bodies.GetID(i);
+			AABB bounds = bodies.GetShape(i)->GetAABB();
+
+			if (id >= m_Proxies.size())
+				m_Proxies.resize(id + 1, NULL_NODE);
+
+			int32_t leaf = m_Proxies[id];
+			if (leaf == NULL_NODE) {
+				leaf = AllocateNode();
+				m_Nodes[leaf].id = id;
+				m_Proxies[id] = leaf;
+			} else {
+				m_Nodes[leaf].bounds = bounds;
+				if (m_Nodes[leaf].fatBounds.Contains(bounds))
+					continue;
+
+				RemoveLeaf(leaf);
+			}
+
+			m_Nodes[leaf].bounds = bounds;
+			m_Nodes[leaf].fatBounds = bounds.Expand(m_Margin);
+			InsertLeaf(leaf);
+			m_MoveBuffer.push_back(id);
+		}
+
+		// find new pairs around moved leaves
+		{
+			NT_PROFILE_SCOPE("Dynamic AABB Tree Pair Query");
+
+			m_NewPairs.clear();
+			for (BodyID id : m_MoveBuffer)
+				QueryPairs(m_Proxies[id]);
+			m_MoveBuffer.clear();
+
+			std::sort(m_NewPairs.begin(), m_NewPairs.end());
+			uint32_t oldSize = m_Pairs.size();
+			m_Pairs.insert(m_Pairs.end(), m_NewPairs.begin(), m_NewPairs.end());
+			std::inplace_merge(m_Pairs.begin(), m_Pairs.begin() + oldSize, m_Pairs.end());
+			m_Pairs.erase(std::unique(m_Pairs.begin(), m_Pairs.end()), m_Pairs.end());
+		}
+
+		// drop pairs that separated, report pairs whose real boxes intersect
+		possibleCollisions.clear();
+		uint32_t kept = 0;
+		for (uint64_t key : m_Pairs) {
+			BodyID idA = key >> 32;
+			BodyID idB = key & 0xFFFFFFFF;
+
+			const Node& A = m_Nodes[m_Proxies[idA]];
+			const Node& B = m_Nodes[m_Proxies[idB]];
+			if (!A.fatBounds.Intersects(B.fatBounds))
+				continue;
+
+			m_Pairs[kept++] = key;
+			if (A.bounds.Intersects(B.bounds))
+				possibleCollisions.push_back({idA, idB});
+		}
+		m_Pairs.resize(kept);
+	}
+
+	void DynamicAABBTree::Query(const AABB& bounds, std::vector<BodyID>& bodies) {
+		bodies.clear();
+		if (m_Root == NULL_NODE)
+			return;
+
+		// fat boxes, since bodies may have moved within them since the last update
+		m_QueryStack.clear();
+		m_QueryStack.push_back(m_Root);
+
+		while (!m_QueryStack.empty()) {
+			int32_t index = m_QueryStack.back();
+			m_QueryStack.pop_back();
+
+			const Node& node = m_Nodes[index];
+			if (!node.fatBounds.Intersects(bounds))
+				continue;
+
+			if (node.IsLeaf()) {
+				bodies.push_back(node.id);
+			} else {
+				m_QueryStack.push_back(node.child1);
+				m_QueryStack.push_back(node.child2);
+			}
+		}
+	}
+
+	void DynamicAABBTree::Remove(BodyID id) { DestroyProxy(id); }
+
+	uint32_t DynamicAABBTree::GetHeight() const {
+		return m_Root == NULL_NODE ? 0 : m_Nodes[m_Root].height;
+	}
+
+	void DynamicAABBTree::DestroyProxy(BodyID id) {
+		if (id >= m_Proxies.size() || m_Proxies[id] == NULL_NODE)
+			return;
+
+		int32_t leaf = m_Proxies[id];
+		RemoveLeaf(leaf);
+		FreeNode(leaf);
+		m_Proxies[id] = NULL_NODE;
+
+		// forget everything about this body, its ID may be reused by a new body before the next
+		// update
+		m_MoveBuffer.erase(std::remove(m_MoveBuffer.begin(), m_MoveBuffer.end(), id),
+						   m_MoveBuffer.end());
+		m_Pairs.erase(std::remove_if(m_Pairs.begin(), m_Pairs.end(),
+									 [id](uint64_t key) {
+										 return (BodyID) (key >> 32) == id ||
+												(BodyID) (key & 0xFFFFFFFF) == id;
+									 }),
+					  m_Pairs.end());
+	}
+
+	int32_t DynamicAABBTree::AllocateNode() {
+		if (m_FreeList == NULL_NODE) {
+			m_Nodes.emplace_back();
+			m_Nodes.back().next = NULL_NODE;
+			m_Nodes.back().height = -1;
+			m_FreeList = m_Nodes.size() - 1;
+		}
+
+		int32_t node = m_FreeList;
+		m_FreeList = m_Nodes[node].next;
+
+		m_Nodes[node].parent = NULL_NODE;
+		m_Nodes[node].child1 = NULL_NODE;
+		m_Nodes[node].child2 = NULL_NODE;
+		m_Nodes[node].height = 0;
+		return node;
+	}
+
+	void DynamicAABBTree::FreeNode(int32_t node) {
+		m_Nodes[node].height = -1;
+		m_Nodes[node].next = m_FreeList;
+		m_FreeList = node;
+	}
+
+	void DynamicAABBTree::InsertLeaf(int32_t leaf) {
+		if (m_Root == NULL_NODE) {
+			m_Root = leaf;
+			m_Nodes[leaf].parent = NULL_NODE;
+			return;
+		}
+
+		// find the best sibling for the leaf, using perimeter as the cost of a node
+		AABB leafBounds = m_Nodes[leaf].fatBounds;
+		int32_t index = m_Root;
+		while (!m_Nodes[index].IsLeaf()) {
+			const Node& node = m_Nodes[index];
+
+			float perimeter = node.fatBounds.GetPerimeter();
+			float combinedPerimeter = AABB::Union(node.fatBounds, leafBounds).GetPerimeter();
+
+			// cost of creating a new parent for this node and the new leaf
+			float cost = 2.0f * combinedPerimeter;
+			// minimum cost of pushing the leaf further down the tree
+			float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+			float childCosts[2];
+			int32_t children[2] = {node.child1, node.child2};
+			for (uint32_t i = 0; i < 2; i++) {
+				const Node& child = m_Nodes[children[i]];
+				float unionPerimeter = AABB::Union(child.fatBounds, leafBounds).GetPerimeter();
+
+				if (child.IsLeaf()) {
+					childCosts[i] = unionPerimeter + inheritanceCost;
+				} else {
+					childCosts[i] =
+						unionPerimeter - child.fatBounds.GetPerimeter() + inheritanceCost;
+				}
+			}
+
+			// descend according to the minimum cost
+			if (cost < childCosts[0] && cost < childCosts[1])
+				break;
+
+			index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+		}
+
+		// create a new parent for the sibling and the leaf
+		int32_t sibling = index;
+		int32_t oldParent = m_Nodes[sibling].parent;
+		int32_t newParent = AllocateNode();
+
+		m_Nodes[newParent].parent = oldParent;
+		m_Nodes[newParent].fatBounds = AABB::Union(leafBounds, m_Nodes[sibling].fatBounds);
+		m_Nodes[newParent].height = m_Nodes[sibling].height + 1;
+		m_Nodes[newParent].child1 = sibling;
+		m_Nodes[newParent].child2 = leaf;
+		m_Nodes[sibling].parent = newParent;
+		m_Nodes[leaf].parent = newParent;
+
+		if (oldParent != NULL_NODE) {
+			if (m_Nodes[oldParent].child1 == sibling)
+				m_Nodes[oldParent].child1 = newParent;
+			else
+				m_Nodes[oldParent].child2 = newParent;
+		} else {
+			m_Root = newParent;
+		}
+
+		// walk back up the tree fixing heights and bounds
+		index = m_Nodes[leaf].parent;
+		while (index != NULL_NODE) {
+			index = Balance(index);
+
+			Node& node = m_Nodes[index];
+			node.height = 1 + glm::max(m_Nodes[node.child1].height, m_Nodes[node.child2].height);
+			node.fatBounds =
+				AABB::Union(m_Nodes[node.child1].fatBounds, m_Nodes[node.child2].fatBounds);
+
+			index = node.parent;
+		}
+	}
+
+	void DynamicAABBTree::RemoveLeaf(int32_t leaf) {
+		if (leaf == m_Root) {
+			m_Root = NULL_NODE;
+			return;
+		}
+
+		int32_t parent = m_Nodes[leaf].parent;
+		int32_t grandParent = m_Nodes[parent].parent;
+		int32_t sibling =
+			m_Nodes[parent].child1 == leaf ? m_Nodes[parent].child2 : m_Nodes[parent].child1;
+
+		if (grandParent != NULL_NODE) {
+			// destroy parent and connect sibling to grandparent
+			if (m_Nodes[grandParent].child1 == parent)
+				m_Nodes[grandParent].child1 = sibling;
+			else
+				m_Nodes[grandParent].child2 = sibling;
+			m_Nodes[sibling].parent = grandParent;
+			FreeNode(parent);
+
+			// adjust ancestor bounds
+			int32_t index = grandParent;
+			while (index != NULL_NODE) {
+				index = Balance(index);
+
+				Node& node = m_Nodes[index];
+				node.fatBounds =
+					AABB::Union(m_Nodes[node.child1].fatBounds, m_Nodes[node.child2].fatBounds);
+				node.height =
+					1 + glm::max(m_Nodes[node.child1].height, m_Nodes[node.child2].height);
+
+				index = node.parent;
+			}
+		} else {
+			m_Root = sibling;
+			m_Nodes[sibling].parent = NULL_NODE;
+			FreeNode(parent);
+		}
+	}
+
+	int32_t DynamicAABBTree::Balance(int32_t iA) {
+		Node& A = m_Nodes[iA];
+		if (A.IsLeaf() || A.height < 2)
+			return iA;
+
+		int32_t iB = A.child1;
+		int32_t iC = A.child2;
+		Node& B = m_Nodes[iB];
+		Node& C = m_Nodes[iC];
+
+		int32_t balance = C.height - B.height;
+
+		if (balance > 1) {
+			// rotate C up
+			int32_t iF = C.child1;
+			int32_t iG = C.child2;
+			Node& F = m_Nodes[iF];
+			Node& G = m_Nodes[iG];
+
+			// swap A and C
+			C.child1 = iA;
+			C.parent = A.parent;
+			A.parent = iC;
+
+			// A's old parent should point to C
+			if (C.parent != NULL_NODE) {
+				if (m_Nodes[C.parent].child1 == iA)
+					m_Nodes[C.parent].child1 = iC;
+				else
+					m_Nodes[C.parent].child2 = iC;
+			} else {
+				m_Root = iC;
+			}
+
+			// keep the taller of F and G under C
+			if (F.height > G.height) {
+				C.child2 = iF;
+				A.child2 = iG;
+				G.parent = iA;
+				A.fatBounds = AABB::Union(B.fatBounds, G.fatBounds);
+				C.fatBounds = AABB::Union(A.fatBounds, F.fatBounds);
+
+				A.height = 1 + glm::max(B.height, G.height);
+				C.height = 1 + glm::max(A.height, F.height);
+			} else {
+				C.child2 = iG;
+				A.child2 = iF;
+				F.parent = iA;
+				A.fatBounds = AABB::Union(B.fatBounds, F.fatBounds);
+				C.fatBounds = AABB::Union(A.fatBounds, G.fatBounds);
+
+				A.height = 1 + glm::max(B.height, F.height);
+				C.height = 1 + glm::max(A.height, G.height);
+			}
+
+			return iC;
+		}
+
+		if (balance < -1) {
+			// rotate B up
+			int32_t iD = B.child1;
+			int32_t iE = B.child2;
+			Node& D = m_Nodes[iD];
+			Node& E = m_Nodes[iE];
+
+			// swap A and B
+			B.child1 = iA;
+			B.parent = A.parent;
+			A.parent = iB;
+
+			// A's old parent should point to B
+			if (B.parent != NULL_NODE) {
+				if (m_Nodes[B.parent].child1 == iA)
+					m_Nodes[B.parent].child1 = iB;
+				else
+					m_Nodes[B.parent].child2 = iB;
+			} else {
+				m_Root = iB;
+			}
+
+			// keep the taller of D and E under B
+			if (D.height > E.height) {
+				B.child2 = iD;
+				A.child1 = iE;
+				E.parent = iA;
+				A.fatBounds = AABB::Union(C.fatBounds, E.fatBounds);
+				B.fatBounds = AABB::Union(A.fatBounds, D.fatBounds);
+
+				A.height = 1 + glm::max(C.height, E.height);
+				B.height = 1 + glm::max(A.height, D.height);
+			} else {
+				B.child2 = iE;
+				A.child1 = iD;
+				D.parent = iA;
+				A.fatBounds = AABB::Union(C.fatBounds, D.fatBounds);
+				B.fatBounds = AABB::Union(A.fatBounds, E.fatBounds);
+
+				A.height = 1 + glm::max(C.height, D.height);
+				B.height = 1 + glm::max(A.height, E.height);
+			}
+
+			return iB;
+		}
+
+		return iA;
+	}
+
+	void DynamicAABBTree::QueryPairs(int32_t leaf) {
+		const AABB& bounds = m_Nodes[leaf].fatBounds;
+		BodyID id = m_Nodes[leaf].id;
+
+		m_QueryStack.clear();
+		m_QueryStack.push_back(m_Root);
+
+		while (!m_QueryStack.empty()) {
+			int32_t index = m_QueryStack.back();
+			m_QueryStack.pop_back();
+
+			const Node& node = m_Nodes[index];
+			if (!node.fatBounds.Intersects(bounds))
+				continue;
+
+			if (node.IsLeaf()) {
+				if (index != leaf)
+					m_NewPairs.push_back(PairKey(id, node.id));
+			} else {
+				m_QueryStack.push_back(node.child1);
+				m_QueryStack.push_back(node.child2);
+			}
+		}
+	}
+} // namespace Fizz
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Objects/AABB.hpp"
+#include "Objects/BodyStore.hpp"
+#include "BroadPhase.hpp"
+
+namespace Fizz {
+	/* Persistent broad phase built on a bounding volume hierarchy of "fat" AABBs (bounding boxes
+	   grown by a margin). Every object gets a leaf in the tree, which is only reinserted when the
+	   object's real bounding box escapes its fat box. Candidate pairs are also kept between
+	   updates: new pairs are only searched for around leaves that were reinserted, and existing
+	   pairs are dropped once their fat boxes separate. The work done per update therefore scales
+	   with the number of moving objects rather than the total number of objects.
+
+	   Internally, the tree is balanced with AVL-style rotations, and nodes are stored in a single
+	   array with a free list so that the tree never allocates once it has reached a steady size.
+	 */
+	class DynamicAABBTree : public BroadPhase {
+	  public:
+		/* Creates an empty tree.
+
+		   @param margin: The distance each leaf's fat bounding box extends past its object's real
+		   bounding box. Larger margins mean fewer reinsertions but more candidate pairs.
+		 */
+		DynamicAABBTree(float margin = 0.1f);
+		~DynamicAABBTree();
+
+		virtual void FindPossibleCollisions(const BodyStore& bodies,
+											CollisionList& possibleCollisions) override;
+
+		virtual void Query(const AABB& bounds, std::vector<BodyID>& bodies) override;
+
+		virtual void Remove(BodyID id) override;
+
+		virtual BroadPhaseType GetType() const override { return BroadPhaseType::DYNAMIC_TREE; }
+
+		/* Gets the height of the tree. A tree holding a single leaf has height 0. */
+		uint32_t GetHeight() const;
+
+	  private:
+		struct Node {
+			AABB fatBounds;
+			// real bounding box of the object (leaves only)
+			AABB bounds;
+
+			union {
+				int32_t parent;
+				// next node in the free list (free nodes only)
+				int32_t next;
+			};
+			int32_t child1, child2;
+
+			// leaves have height 0, free nodes have height -1
+			int32_t height;
+
+			// body stored in this node (leaves only)
+			BodyID id;
+
+			inline bool IsLeaf() const { return child1 == NULL_NODE; }
+		};
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t node);
+
+		void InsertLeaf(int32_t leaf);
+		void RemoveLeaf(int32_t leaf);
+
+		/* Performs a left or right rotation if node is unbalanced. Returns the new root index of
+		   the subtree.
+		 */
+		int32_t Balance(int32_t node);
+
+		/* Adds a candidate pair for every leaf whose fat box overlaps the given leaf's fat box */
+		void QueryPairs(int32_t leaf);
+
+		/* Removes a body's leaf from the tree, if it has one */
+		void DestroyProxy(BodyID id);
+
+	  private:
+		static const int32_t NULL_NODE;
+
+		float m_Margin;
+
+		std::vector<Node> m_Nodes;
+		int32_t m_Root;
+		int32_t m_FreeList;
+
+		// leaf node holding each body, indexed by body ID
+		std::vector<int32_t> m_Proxies;
+		// bodies whose leaves were (re)inserted since the last update
+		std::vector<BodyID> m_MoveBuffer;
+
+		// sorted, persistent list of body ID pairs whose fat boxes overlap, packed as
+		// (smaller ID << 32 | larger ID)
+		std::vector<uint64_t> m_Pairs;
+		std::vector<uint64_t> m_NewPairs;
+
+		std::vector<int32_t> m_QueryStack;
+	};
+} // namespace Fizz
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Nutella.hpp>
+
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Fizz {
+	/* Bump allocator for short lived objects that are all thrown away at once (e.g. at the end of
+	   a simulation step). Memory is handed out from fixed size chunks, which are kept when the
+	   arena is reset so that they can be reused. Once the arena has grown to fit a typical step,
+	   allocations never touch the heap, and resetting is O(1).
+
+	   Memory is returned uninitialized, and objects are never destroyed, so only trivially
+	   destructible types may be stored.
+	 */
+	template <typename T, uint32_t ChunkSize = 1024> class FrameArena {
+	  public:
+		FrameArena() : m_Chunk(0), m_Offset(0) {}
+		~FrameArena() {
+			for (T* chunk : m_Chunks)
+				::operator delete(chunk);
+		}
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		/* Allocates space for a contiguous block of objects. The block stays valid until the arena
+		   is reset.
+
+		   @param count: The number of objects to allocate space for. Must be at most ChunkSize.
+
+		   @return Pointer to the (uninitialized) first object
+		 */
+		inline T* Allocate(uint32_t count = 1) {
+			// checked here rather than at class scope, so T may be incomplete where the arena is
+			// declared
+			static_assert(std::is_trivially_destructible<T>::value,
+						  "FrameArena never runs destructors!");
+			NT_ASSERT(count <= ChunkSize, "Block does not fit in a single arena chunk!");
+
+			if (m_Offset + count > ChunkSize) {
+				m_Chunk++;
+				m_Offset = 0;
+			}
+
+			if (m_Chunk == m_Chunks.size())
+				m_Chunks.push_back(static_cast<T*>(::operator new(ChunkSize * sizeof(T))));
+
+			T* block = m_Chunks[m_Chunk] + m_Offset;
+			m_Offset += count;
+			return block;
+		}
+
+		/* Releases every allocation made since the last reset. Chunks are kept for reuse. */
+		inline void Reset() {
+			m_Chunk = 0;
+			m_Offset = 0;
+		}
+
+	  private:
+		std::vector<T*> m_Chunks;
+		uint32_t m_Chunk;
+		uint32_t m_Offset;
+	};
+} // namespace Fizz
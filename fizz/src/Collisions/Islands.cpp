@@ -0,0 +1,127 @@
+#include "Islands.hpp"
+
+#include <Nutella.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace Fizz {
+	// kinetic energy per unit mass below which a body counts as resting. Per unit mass, so that
+	// small and large bodies fall asleep at the same speed.
+	static const float SLEEP_ENERGY = 0.5f * 0.05f * 0.05f;
+	// number of consecutive updates every body in an island must rest for before it sleeps
+	static const uint32_t SLEEP_FRAMES = 30;
+
+	Islands::Islands() {}
+	Islands::~Islands() {}
+
+	void Islands::Build(const BodyStore& bodies, const std::vector<Collision>& collisions,
+						const CollisionList& restingPairs) {
+		NT_PROFILE_FUNC();
+
+		m_Parents.resize(bodies.Size());
+		m_Sizes.resize(bodies.Size());
+		for (uint32_t i = 0; i < bodies.Size(); i++) {
+			m_Parents[i] = i;
+			m_Sizes[i] = 1;
+		}
+
+		auto link = [&](BodyID A, BodyID B) {
+			uint32_t indexA = bodies.GetIndex(A);
+			uint32_t indexB = bodies.GetIndex(B);
+
+			// static bodies would join everything standing on them into one island. Moving ones
+			// are linked anyway, since everything they touch must stay awake while they move.
+			if ((bodies.GetInvMass(indexA) != 0.0f || bodies.IsAwake(indexA)) &&
+				(bodies.GetInvMass(indexB) != 0.0f || bodies.IsAwake(indexB)))
+				Union(indexA, indexB);
+		};
+
+		for (const Collision& collision : collisions)
+			link(collision.collider, collision.collided);
+		for (auto [A, B] : restingPairs)
+			link(A, B);
+
+		for (uint32_t i = 0; i < bodies.Size(); i++)
+			m_Parents[i] = Find(i);
+	}
+
+	void Islands::Wake(BodyStore& bodies) {
+		NT_PROFILE_FUNC();
+
+		m_Awake.assign(bodies.Size(), false);
+		for (uint32_t i = 0; i < bodies.Size(); i++) {
+			if (bodies.IsAwake(i))
+				m_Awake[m_Parents[i]] = true;
+		}
+
+		for (uint32_t i = 0; i < bodies.Size(); i++) {
+			if (m_Awake[m_Parents[i]])
+				bodies.Wake(i);
+		}
+	}
+
+	void Islands::Sleep(BodyStore& bodies) {
+		NT_PROFILE_FUNC();
+
+		m_RestFrames.assign(bodies.Size(), std::numeric_limits<uint32_t>::max());
+		for (uint32_t i = 0; i < bodies.Size(); i++) {
+			if (!bodies.IsAwake(i))
+				continue;
+
+			// moving static bodies are never pushed to rest, so their island stays awake until
+			// they are stopped
+			if (bodies.GetInvMass(i) == 0.0f) {
+				bool moving = bodies.GetVelocity(i) != glm::vec2(0.0f) ||
+							  bodies.GetAngularVelocity(i) != 0.0f;
+				uint32_t frames = moving ? 0 : SLEEP_FRAMES;
+				bodies.SetRestFrames(i, frames);
+				m_RestFrames[m_Parents[i]] = std::min(m_RestFrames[m_Parents[i]], frames);
+				continue;
+			}
+
+			// spin counts through the body's inertia per unit mass. Bodies that never turn
+			// (e.g. segments given mass) have no rotational energy.
+			const glm::vec2& velocity = bodies.GetVelocity(i);
+			float spin = bodies.GetAngularVelocity(i);
+			float invInertia = bodies.GetInvInertia(i);
+			float inertiaPerMass = invInertia != 0.0f ? bodies.GetInvMass(i) / invInertia : 0.0f;
+			float energy = 0.5f * (glm::dot(velocity, velocity) + spin * spin * inertiaPerMass);
+
+			uint32_t frames = energy < SLEEP_ENERGY ? bodies.GetRestFrames(i) + 1 : 0;
+			bodies.SetRestFrames(i, frames);
+
+			uint32_t& islandFrames = m_RestFrames[m_Parents[i]];
+			islandFrames = std::min(islandFrames, frames);
+		}
+
+		for (uint32_t i = 0; i < bodies.Size(); i++) {
+			if (bodies.IsAwake(i) && m_RestFrames[m_Parents[i]] >= SLEEP_FRAMES)
+				bodies.Sleep(i);
+		}
+	}
+
+	uint32_t Islands::Find(uint32_t index) {
+		// path halving: point every other body on the way at its grandparent
+		while (m_Parents[index] != index) {
+			m_Parents[index] = m_Parents[m_Parents[index]];
+			index = m_Parents[index];
+		}
+
+		return index;
+	}
+
+	void Islands::Union(uint32_t A, uint32_t B) {
+		A = Find(A);
+		B = Find(B);
+		if (A == B)
+			return;
+
+		// hang the smaller tree under the larger, so trees stay shallow
+		if (m_Sizes[A] < m_Sizes[B])
+			std::swap(A, B);
+
+		m_Parents[B] = A;
+		m_Sizes[A] += m_Sizes[B];
+	}
+} // namespace Fizz
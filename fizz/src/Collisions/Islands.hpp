@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Objects/BodyStore.hpp"
+#include "BroadPhase.hpp"
+#include "CollisionDetection.hpp"
+
+namespace Fizz {
+	/* Splits the bodies of an environment into islands: groups of bodies joined by chains of
+	   touching contacts. Static bodies only join an island while they move, otherwise everything
+	   resting on the ground would end up in one.
+
+	   Bodies in an island push on each other, so islands wake and fall asleep as a whole. An
+	   island falls asleep once every body in it has been nearly still for a number of updates,
+	   and wakes as soon as any of its bodies is woken, e.g. by being hit by an awake body.
+	 */
+	class Islands {
+	  public:
+		Islands();
+		~Islands();
+
+		/* Groups bodies by the contacts between them, using a union-find over the collisions.
+
+		   @param bodies: The body store holding the bodies
+		   @param collisions: The collisions found this update. Must all exist.
+		   @param restingPairs: Pairs of sleeping bodies that were touching when they fell
+		   asleep. These are not checked for collisions while asleep, but still hold their
+		   islands together.
+		 */
+		void Build(const BodyStore& bodies, const std::vector<Collision>& collisions,
+				   const CollisionList& restingPairs);
+
+		/* Wakes every body in an island that has at least one awake body. Must be called after
+		   Build, and before contacts are solved.
+
+		   @param bodies: The body store the islands were built from
+		 */
+		void Wake(BodyStore& bodies);
+
+		/* Counts how many updates each awake body has been resting for, and puts every island
+		   whose bodies have all rested for long enough to sleep. Must be called after contacts
+		   are solved.
+
+		   @param bodies: The body store the islands were built from
+		 */
+		void Sleep(BodyStore& bodies);
+
+		/* Gets the island a body belongs to, identified by the index of one of its bodies.
+		   Static bodies that are not moving are alone in their own island.
+
+		   @param index: The index of the body in the body store
+		 */
+		inline uint32_t GetIsland(uint32_t index) const { return m_Parents[index]; }
+
+	  private:
+		/* Finds the root of the tree holding a body, flattening the path to it */
+		uint32_t Find(uint32_t index);
+
+		/* Merges the trees holding two bodies */
+		void Union(uint32_t A, uint32_t B);
+
+	  private:
+		// union-find forest over body indices. After Build, every body points to its root.
+		std::vector<uint32_t> m_Parents;
+		std::vector<uint32_t> m_Sizes;
+
+		// per island (indexed by root): the fewest updates any of its bodies has rested for
+		std::vector<uint32_t> m_RestFrames;
+		std::vector<uint8_t> m_Awake;
+	};
+} // namespace Fizz
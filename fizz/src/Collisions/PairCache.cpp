@@ -0,0 +1,46 @@
+#include "PairCache.hpp"
+
+#include <Nutella.hpp>
+
+namespace Fizz {
+	PairCache::PairCache() : m_Update(0) {}
+	PairCache::~PairCache() {}
+
+	void PairCache::Update(const CollisionList& pairs, std::vector<PairState*>& states) {
+		NT_PROFILE_FUNC();
+
+		m_Update++;
+		states.resize(pairs.size());
+
+		for (uint32_t i = 0; i < pairs.size(); i++) {
+			auto [A, B] = pairs[i];
+			PairState& state = m_States[Key(A, B)];
+			state.lastSeen = m_Update;
+			states[i] = &state;
+		}
+
+		// pairs that stopped overlapping in the broad phase start over if they meet again
+		if (m_States.size() > pairs.size()) {
+			for (auto it = m_States.begin(); it != m_States.end();) {
+				if (it->second.lastSeen != m_Update)
+					it = m_States.erase(it);
+				else
+					++it;
+			}
+		}
+	}
+
+	void PairCache::Remove(BodyID id) {
+		for (auto it = m_States.begin(); it != m_States.end();) {
+			BodyID first = it->first >> 32;
+			BodyID second = it->first & 0xFFFFFFFF;
+
+			if (first == id || second == id)
+				it = m_States.erase(it);
+			else
+				++it;
+		}
+	}
+
+	void PairCache::Clear() { m_States.clear(); }
+} // namespace Fizz
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Objects/BodyStore.hpp"
+#include "BroadPhase.hpp"
+#include "CollisionDetection.hpp"
+
+namespace Fizz {
+	/* Impulses the solver applied at a contact point, used to warm start it on the next update */
+	struct CachedImpulse {
+		// ID of the contact point, see ContactPoint
+		uint32_t id;
+		float normalImpulse;
+		float tangentImpulse;
+	};
+
+	/* Collision state kept for a pair of bodies between updates */
+	struct PairState {
+		GJKCache gjk;
+
+		// impulses from the last update the pair was colliding in. Empty if it was not colliding.
+		CachedImpulse impulses[2];
+		uint32_t numImpulses = 0;
+
+		// update the pair was last reported by the broad phase
+		uint64_t lastSeen;
+	};
+
+	/* Keeps collision state for every pair of bodies reported by the broad phase, so that the
+	   narrow phase and the solver can start each update from where the last one ended. State is
+	   created when a pair first shows up, and dropped as soon as the broad phase stops reporting
+	   it.
+
+	   Pairs are identified by the IDs of their bodies in order, so a pair must be reported with
+	   its bodies in the same order every update for its state to be found again.
+	 */
+	class PairCache {
+	  public:
+		PairCache();
+		~PairCache();
+
+		/* Finds the state of each pair reported this update, and drops the state of any pair that
+		   was not reported. The returned pointers stay valid until the next call to Update or
+		   Remove, and point to different states for different pairs, so they may be written from
+		   several threads at once as long as each pair is handled by one thread.
+
+		   @param pairs: Every pair reported by the broad phase this update
+		   @param states: Output list of the state of each pair, in the same order as pairs
+		 */
+		void Update(const CollisionList& pairs, std::vector<PairState*>& states);
+
+		/* Drops the state of every pair involving a body. Must be called when a body is removed,
+		   since its ID may be reused.
+
+		   @param id: The ID of the body being removed
+		 */
+		void Remove(BodyID id);
+
+		/* Drops all state */
+		void Clear();
+
+		inline uint32_t Size() const { return m_States.size(); }
+
+	  private:
+		static inline uint64_t Key(BodyID first, BodyID second) {
+			return (uint64_t) first << 32 | second;
+		}
+
+	  private:
+		// nodes of an unordered map never move, so states can be handed out by pointer
+		std::unordered_map<uint64_t, PairState> m_States;
+		uint64_t m_Update;
+	};
+} // namespace Fizz
@@ -1,32 +1,26 @@
 #include "Quadtree.hpp"
 
 namespace Fizz {
-	const uint32_t Quadtree::MAX_LEVELS = 5;
+	const uint32_t Quadtree::MAX_LEVELS = 16;
 
-	Quadtree::Quadtree(uint32_t level, const AABB& bounds)
-		: m_Level(level), m_Bounds(bounds), m_Nodes(nullptr) {}
+	Quadtree::Quadtree(uint32_t level, const AABB& bounds, QuadtreeArena& arena, uint32_t maxLevel)
+		: m_Arena(&arena), m_Level(level), m_MaxLevel(glm::min(maxLevel, MAX_LEVELS)),
+		  m_Nodes(nullptr), m_Objects(nullptr), m_Bounds(bounds) {}
 
-	Quadtree::~Quadtree() {
-		if (m_Nodes) {
-			m_Nodes[0].~Quadtree();
-			m_Nodes[1].~Quadtree();
-			m_Nodes[2].~Quadtree();
-			m_Nodes[3].~Quadtree();
-		}
+	void Quadtree::Clear() {
+		m_Objects = nullptr;
+		m_Nodes = nullptr;
 	}
 
-	void Quadtree::Clear() {
-		m_Objects.clear();
+	void Quadtree::Insert(BodyID id, const AABB& bounds) {
+		QuadtreeEntry* entry = m_Arena->entries.Allocate();
+		entry->bounds = bounds;
+		entry->id = id;
 
-		if (m_Nodes) {
-			m_Nodes[0].~Quadtree();
-			m_Nodes[1].~Quadtree();
-			m_Nodes[2].~Quadtree();
-			m_Nodes[3].~Quadtree();
-		}
+		Insert(entry);
 	}
 
-	void Quadtree::Insert(Nutella::Ref<PhysicsObject>& object) {
+	void Quadtree::Insert(QuadtreeEntry* entry) {
 		// calculate bounds of children
 		glm::vec2 halfWidth = glm::vec2(m_Bounds.GetWidth() / 2, 0.0f);
 		glm::vec2 halfHeight = glm::vec2(0.0f, m_Bounds.GetHeight() / 2);
@@ -35,7 +29,7 @@ namespace Fizz {
 		AABB tr = AABB(m_Bounds.min + halfWidth + halfHeight, m_Bounds.max);
 		AABB bl = AABB(m_Bounds.min, m_Bounds.max - halfWidth - halfHeight);
 		AABB br = AABB(m_Bounds.min + halfWidth, m_Bounds.max - halfHeight);
-		AABB shape = object->GetShape()->GetAABB();
+		const AABB& shape = entry->bounds;
 
 		// check if shape can be contained by any smaller children
 		int idx = -1;
@@ -49,44 +43,38 @@ namespace Fizz {
 			idx = 3;
 		}
 
-		if (idx != -1 && m_Level < MAX_LEVELS) {
+		if (idx != -1 && m_Level < m_MaxLevel) {
 			// shape can be contained in a child node -> add to child
 			// create children if needed
 			if (!m_Nodes) {
-				m_Nodes = (Quadtree*) malloc(4 * sizeof(Quadtree));
-				new (&m_Nodes[0]) Quadtree(m_Level + 1, tl);
-				new (&m_Nodes[1]) Quadtree(m_Level + 1, tr);
-				new (&m_Nodes[2]) Quadtree(m_Level + 1, bl);
-				new (&m_Nodes[3]) Quadtree(m_Level + 1, br);
+				m_Nodes = m_Arena->nodes.Allocate(4);
+				new (&m_Nodes[0]) Quadtree(m_Level + 1, tl, *m_Arena, m_MaxLevel);
+				new (&m_Nodes[1]) Quadtree(m_Level + 1, tr, *m_Arena, m_MaxLevel);
+				new (&m_Nodes[2]) Quadtree(m_Level + 1, bl, *m_Arena, m_MaxLevel);
+				new (&m_Nodes[3]) Quadtree(m_Level + 1, br, *m_Arena, m_MaxLevel);
 			}
 
-			m_Nodes[idx].Insert(object);
+			m_Nodes[idx].Insert(entry);
 		} else {
-			m_Objects.push_back(object);
+			entry->next = m_Objects;
+			m_Objects = entry;
 		}
 	}
 
-	CollisionList Quadtree::GetPossibleCollisions() {
-		CollisionList collisions;
-		GetPossibleCollisions(collisions);
-		return collisions;
-	}
-
 	void Quadtree::GetPossibleCollisions(CollisionList& collisions) {
 		// find all collisions between objects in current node
-		for (uint32_t i = 0; i < m_Objects.size(); i++) {
-			for (u_int32_t j = i + 1; j < m_Objects.size(); j++) {
-				if (m_Objects[i]->GetShape()->GetAABB().Intersects(
-						m_Objects[j]->GetShape()->GetAABB()))
-					collisions.push_back({m_Objects[i], m_Objects[j]});
+		for (QuadtreeEntry* a = m_Objects; a; a = a->next) {
+			for (QuadtreeEntry* b = a->next; b; b = b->next) {
+				if (a->bounds.Intersects(b->bounds))
+					collisions.push_back({a->id, b->id});
 			}
 		}
 
 		if (m_Nodes) {
 			// find all collisions between an object in this node and an object in a child node
-			for (uint32_t i = 0; i < m_Objects.size(); i++) {
+			for (QuadtreeEntry* entry = m_Objects; entry; entry = entry->next) {
 				for (uint32_t j = 0; j < 4; j++) {
-					m_Nodes[j].GetPossibleChildCollisions(m_Objects[i], collisions);
+					m_Nodes[j].GetPossibleChildCollisions(*entry, collisions);
 				}
 			}
 
@@ -97,33 +85,36 @@ namespace Fizz {
 		}
 	}
 
-	void Quadtree::GetPossibleChildCollisions(const Nutella::Ref<PhysicsObject>& object,
+	void Quadtree::GetPossibleChildCollisions(const QuadtreeEntry& entry,
 											  CollisionList& collisions) {
-		for (auto& other : m_Objects) {
-			if (other->GetShape()->GetAABB().Intersects(object->GetShape()->GetAABB())) {
-				collisions.push_back({object, other});
+		// everything in this subtree is contained in its bounds
+		if (!m_Bounds.Intersects(entry.bounds))
+			return;
+
+		for (QuadtreeEntry* other = m_Objects; other; other = other->next) {
+			if (other->bounds.Intersects(entry.bounds)) {
+				collisions.push_back({entry.id, other->id});
 			}
 		}
 
 		if (m_Nodes) {
 			for (uint32_t i = 0; i < 4; i++) {
-				m_Nodes[i].GetPossibleChildCollisions(object, collisions);
+				m_Nodes[i].GetPossibleChildCollisions(entry, collisions);
 			}
 		}
 	}
 
-	std::vector<Nutella::Ref<PhysicsObject>> Quadtree::GetPossibleCollisions(const AABB& bounds) {
-		std::vector<Nutella::Ref<PhysicsObject>> collisions;
+	std::vector<BodyID> Quadtree::GetPossibleCollisions(const AABB& bounds) {
+		std::vector<BodyID> collisions;
 		GetPossibleCollisions(bounds, collisions);
 		return collisions;
 	}
 
-	void Quadtree::GetPossibleCollisions(const AABB& bounds,
-										 std::vector<Nutella::Ref<PhysicsObject>>& collisions) {
+	void Quadtree::GetPossibleCollisions(const AABB& bounds, std::vector<BodyID>& collisions) {
 		// check AABB against all objects in current node
-		for (auto other : m_Objects) {
-			if (other->GetShape()->GetAABB().Intersects(bounds)) {
-				collisions.push_back(other);
+		for (QuadtreeEntry* other = m_Objects; other; other = other->next) {
+			if (other->bounds.Intersects(bounds)) {
+				collisions.push_back(other->id);
 			}
 		}
 
@@ -131,8 +122,56 @@ namespace Fizz {
 		if (m_Nodes) {
 			for (uint32_t i = 0; i < 4; i++)
 				if (m_Nodes[i].m_Bounds.Intersects(bounds)) {
-					GetPossibleCollisions(bounds, collisions);
+					m_Nodes[i].GetPossibleCollisions(bounds, collisions);
 				}
 		}
 	}
+
+	void QuadtreeBroadPhase::FindPossibleCollisions(const BodyStore& bodies,
+													CollisionList& possibleCollisions) {
+		NT_PROFILE_FUNC();
+
+		if (bodies.Size() == 0) {
+			possibleCollisions.clear();
+			m_Root = nullptr;
+			return;
+		}
+
+		// fit root to the objects, so no object is left in the root for being out of bounds
+		m_Bounds.resize(bodies.Size());
+		AABB world = bodies.GetShape(0)->GetAABB();
+		float totalExtent = 0.0f;
+		for (uint32_t i = 0; i < bodies.Size(); i++) {
+			const AABB& bounds = m_Bounds[i] = bodies.GetShape(i)->GetAABB();
+			world = AABB::Union(world, bounds);
+			totalExtent += glm::max(bounds.GetWidth(), bounds.GetHeight());
+		}
+
+		// keep nodes square, and pad so objects on the border are still strictly contained
+		float rootSize = glm::max(world.GetWidth(), world.GetHeight()) * 1.01f + 0.01f;
+		glm::vec2 center = (world.min + world.max) / 2.0f;
+		AABB root(center - rootSize / 2.0f, center + rootSize / 2.0f);
+
+		// split until cells are about twice the size of an average object, deeper splits would
+		// mostly leave objects straddling cell borders
+		float cellSize = glm::max(2.0f * totalExtent / bodies.Size(), 1e-4f);
+		uint32_t maxLevel = glm::max(glm::ceil(glm::log2(rootSize / cellSize)), 0.0f);
+
+		// previous tree is no longer referenced, all of its memory can be reused. The root lives
+		// in the arena too, so the tree can still be queried after this update.
+		m_Arena.Reset();
+		m_Root = new (m_Arena.nodes.Allocate(1)) Quadtree(0, root, m_Arena, maxLevel);
+		for (uint32_t i = 0; i < bodies.Size(); i++)
+			m_Root->Insert(bodies.GetID(i), m_Bounds[i]);
+
+		// filled in place, so the list keeps its capacity from the last update
+		possibleCollisions.clear();
+		m_Root->GetPossibleCollisions(possibleCollisions);
+	}
+
+	void QuadtreeBroadPhase::Query(const AABB& bounds, std::vector<BodyID>& bodies) {
+		bodies.clear();
+		if (m_Root)
+			m_Root->GetPossibleCollisions(bounds, bodies);
+	}
 } // namespace Fizz
@@ -3,60 +3,123 @@
 #include <vector>
 
 #include "Objects/AABB.hpp"
-#include "Objects/PhysicsObject.hpp"
+#include "Objects/BodyStore.hpp"
+#include "BroadPhase.hpp"
+#include "FrameArena.hpp"
 
 namespace Fizz {
-	using CollisionList =
-		std::vector<std::pair<Nutella::Ref<PhysicsObject>, Nutella::Ref<PhysicsObject>>>;
+	class Quadtree;
+
+	/* An object stored in a quadtree node. Entries form a singly linked list per node. */
+	struct QuadtreeEntry {
+		AABB bounds;
+		BodyID id;
+		QuadtreeEntry* next;
+	};
+
+	/* Memory that quadtree nodes and their object lists are allocated from. Nothing is freed until
+	   the arena is reset, which invalidates every tree built from it at once.
+	 */
+	struct QuadtreeArena {
+		FrameArena<Quadtree> nodes;
+		FrameArena<QuadtreeEntry> entries;
+
+		inline void Reset() {
+			nodes.Reset();
+			entries.Reset();
+		}
+	};
 
 	/* Linked list-eque data structure used for a broad phase collision detection filter. As the
-	   name suggests, each node has four children, which are dynamically allocated / freed as
-	   necessary.
+	   name suggests, each node has four children, which are allocated from an arena as necessary.
+	   A tree never frees its own memory; it lives until the arena it was built from is reset.
 	 */
 	class Quadtree {
 	  public:
-		Quadtree(uint32_t level, const AABB& bounds);
-		~Quadtree();
+		/* Creates an empty quadtree node.
+
+		   @param level: The depth of this node in the tree (0 for the root)
+		   @param bounds: The region this node covers
+		   @param arena: The arena to allocate children and object lists from
+		   @param maxLevel: The depth past which nodes are no longer split. Clamped to MAX_LEVELS.
+		 */
+		Quadtree(uint32_t level, const AABB& bounds, QuadtreeArena& arena, uint32_t maxLevel = 5);
 
-		/* Removes all objects from the quadtree and deletes all children. */
+		/* Removes all objects from the quadtree and detaches all children. Their memory is
+		   reclaimed when the arena is reset.
+		 */
 		void Clear();
 
-		/* Adds a physics object to the quadtee. Objects are recursively inserted into the smallest
-		   child quadtree that can completely contain them.
+		/* Adds a body to the quadtee. Bodies are recursively inserted into the smallest child
+		   quadtree that can completely contain them.
 
-		   @param object: the physics object to insert
+		   @param id: the ID of the body to insert
+		   @param bounds: the bounding box of the body
 		 */
-		void Insert(Nutella::Ref<PhysicsObject>& object);
+		void Insert(BodyID id, const AABB& bounds);
 
-		/* Returns a pairwise list of all possible collisions in the quadtree. Collisions are
-		   filtered by their location in the quatree as while as by AABB intersection checks.
+		/* Adds a pairwise list of all possible collisions in the quadtree to a list, without
+		   clearing it first. Collisions are filtered by their location in the quatree as while as
+		   by AABB intersection checks.
 
-		   @return A list of pairs of physics objects that may be colliding
+		   @param collisions: the list to add pairs of body IDs that may be colliding to
 		*/
-		CollisionList GetPossibleCollisions();
+		void GetPossibleCollisions(CollisionList& collisions);
 
 		/* Returns a list of possible collisions with the given bounds. Collisions are
 		   filtered by their location in the quatree as while as by AABB intersection checks.
 
 		   @param bounds: an AABB to check for collisions with
-		   @return A list of physics objects that may be colliding with the bounds
+		   @return A list of IDs of bodies that may be colliding with the bounds
 		*/
-		std::vector<Nutella::Ref<PhysicsObject>> GetPossibleCollisions(const AABB& bounds);
+		std::vector<BodyID> GetPossibleCollisions(const AABB& bounds);
+
+		/* Adds the IDs of bodies that may be colliding with the given bounds to a list, without
+		   clearing it first.
+
+		   @param bounds: an AABB to check for collisions with
+		   @param collisions: the list to add the IDs to
+		*/
+		void GetPossibleCollisions(const AABB& bounds, std::vector<BodyID>& collisions);
 
 	  private:
-		void GetPossibleCollisions(CollisionList& collisions);
-		void GetPossibleChildCollisions(const Nutella::Ref<PhysicsObject>& object,
-										CollisionList& collisions);
-		void GetPossibleCollisions(const AABB& bounds,
-								   std::vector<Nutella::Ref<PhysicsObject>>& collisions);
+		void Insert(QuadtreeEntry* entry);
+
+		void GetPossibleChildCollisions(const QuadtreeEntry& entry, CollisionList& collisions);
 
 	  private:
 		static const uint32_t MAX_LEVELS;
 
+		QuadtreeArena* m_Arena;
+
 		uint32_t m_Level;
+		uint32_t m_MaxLevel;
 		Quadtree* m_Nodes;
 
-		std::vector<Nutella::Ref<PhysicsObject>> m_Objects;
+		QuadtreeEntry* m_Objects;
 		AABB m_Bounds;
 	};
+
+	/* Broad phase that rebuilds a quadtree containing every object on each update. The root of the
+	   tree is fit to the objects on every rebuild, and the tree is made deep enough for its
+	   smallest cells to match the size of a typical object, so any world extent is subdivided
+	   evenly. Nodes are allocated from an arena that is reset on every rebuild.
+	 */
+	class QuadtreeBroadPhase : public BroadPhase {
+	  public:
+		virtual void FindPossibleCollisions(const BodyStore& bodies,
+											CollisionList& possibleCollisions) override;
+
+		virtual void Query(const AABB& bounds, std::vector<BodyID>& bodies) override;
+
+		virtual void Remove(BodyID id) override {}
+
+		virtual BroadPhaseType GetType() const override { return BroadPhaseType::QUADTREE; }
+
+	  private:
+		QuadtreeArena m_Arena;
+		// root of the last tree built, kept for queries until the next rebuild
+		Quadtree* m_Root = nullptr;
+		std::vector<AABB> m_Bounds;
+	};
 } // namespace Fizz
@@ -1,62 +1,41 @@
 #pragma once
 
 #include <glm/glm.hpp>
-#include <vector>
+#include <Nutella.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
 
 namespace Fizz {
 
 	/* Represents a set of points in 2 dimensional space. Technically, simplices are always affinely
 	   independent, meaning they can never have more than 3 points (in 2D space). However, this
 	   class has a somewhat looser definition, and is used more as an ordered collection of points.
-	 */
-	template <typename T> class Simplex {
-	  private:
-		class Iterator {
-
-		  public:
-			Iterator(T* ptr) : m_Ptr(ptr) {}
-
-			inline T& operator*() { return *m_Ptr; }
-
-			inline Iterator& operator++() {
-				m_Ptr++;
-				return *this;
-			}
-
-			inline Iterator operator++(int) {
-				Simplex::Iterator temp = *this;
-				++(*this);
-				return temp;
-			}
-
-			inline Iterator& operator--() {
-				m_Ptr--;
-				return *this;
-			}
-
-			inline Iterator operator--(int) {
-				Simplex::Iterator temp = *this;
-				--(*this);
-				return temp;
-			}
-
-			inline bool operator==(const Iterator& rhs) { return m_Ptr == rhs.m_Ptr; }
-			inline bool operator!=(const Iterator& rhs) { return !(*this == rhs); }
-
-		  private:
-			T* m_Ptr;
-		};
 
+	   Points are stored inline, so a simplex never allocates. The capacity defaults to the 3
+	   points a real 2D simplex can have; larger collections (such as the polytope expanded by
+	   EPA) must specify their own bound. Adding to a full simplex is fatal in every build, rather
+	   than writing past the end of the points.
+	 */
+	template <typename T, uint32_t Capacity = 3> class Simplex {
 	  public:
-		Simplex() {}
-		Simplex(std::vector<T> points) : m_Points(points) {}
+		Simplex() : m_Size(0) {}
+		Simplex(std::initializer_list<T> points) : m_Size(0) {
+			for (const T& point : points)
+				Add(point);
+		}
 		~Simplex() {}
 
 		/* Adds the given point to the end of the simplex.
 
 		   @param point: The point to add
 		 */
-		inline void Add(const T& point) { m_Points.push_back(point); }
+		inline void Add(const T& point) {
+			if (m_Size >= Capacity)
+				Overflow();
+			m_Points[m_Size++] = point;
+		}
 
 		/* Adds the given point simplex at the specified index. All points after the index are moved
 		   back to make room for the new point, which will occupy the given index after insertion.
@@ -65,7 +44,14 @@ namespace Fizz {
 		   @param idx: The index to insert the point at
 		 */
 		inline void Add(const T& point, uint32_t idx) {
-			m_Points.insert(m_Points.begin() + idx, point);
+			if (m_Size >= Capacity)
+				Overflow();
+
+			for (uint32_t i = m_Size; i > idx; i--)
+				m_Points[i] = m_Points[i - 1];
+
+			m_Points[idx] = point;
+			m_Size++;
 		}
 
 		/** Removes the given point from the simplex.
@@ -73,9 +59,9 @@ namespace Fizz {
 		 * @param point: The point to remove
 		 */
 		inline void Remove(const T& point) {
-			for (int i = 0; i < m_Points.size(); i++) {
+			for (uint32_t i = 0; i < m_Size; i++) {
 				if (m_Points[i] == point) {
-					m_Points.erase(m_Points.begin() + i);
+					Remove(i);
 					return;
 				}
 			}
@@ -85,18 +71,36 @@ namespace Fizz {
 		 *
 		 * @param idx: The index of the point to remove
 		 */
-		inline void Remove(const uint32_t idx) { m_Points.erase(m_Points.begin() + idx); }
+		inline void Remove(const uint32_t idx) {
+			for (uint32_t i = idx; i + 1 < m_Size; i++)
+				m_Points[i] = m_Points[i + 1];
+
+			m_Size--;
+		}
 
 		/* Gets the number of points in the simplex */
-		inline uint32_t Size() const { return m_Points.size(); }
+		inline uint32_t Size() const { return m_Size; }
+
+		/* Checks whether another point can be added to the simplex */
+		inline bool IsFull() const { return m_Size == Capacity; }
 
 		inline T& operator[](uint32_t index) { return m_Points[index]; }
 		inline const T& operator[](uint32_t index) const { return m_Points[index]; }
 
-		inline Iterator begin() { return Iterator(&m_Points[0]); }
-		inline Iterator end() { return Iterator(&m_Points[0] + m_Points.size()); }
+		inline T* begin() { return m_Points; }
+		inline T* end() { return m_Points + m_Size; }
+		inline const T* begin() const { return m_Points; }
+		inline const T* end() const { return m_Points + m_Size; }
+
+	  private:
+		/* Stops the program when a point is added to a full simplex */
+		[[noreturn]] static void Overflow() {
+			NT_ASSERT(false, "Simplex is full!");
+			std::abort();
+		}
 
 	  private:
-		std::vector<T> m_Points;
+		T m_Points[Capacity];
+		uint32_t m_Size;
 	};
 } // namespace Fizz
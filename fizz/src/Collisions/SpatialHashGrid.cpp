@@ -0,0 +1,183 @@
+#include "SpatialHashGrid.hpp"
+
+namespace Fizz {
+	/** Packs the coordinates of a cell into a single key */
+	static inline uint64_t CellKey(int32_t x, int32_t y) {
+		return (uint64_t) (uint32_t) x << 32 | (uint32_t) y;
+	}
+
+	/** Fibonacci hashing; spreads nearby cells across the table */
+	static inline uint32_t HashCell(uint64_t key) { return (key * 0x9E3779B97F4A7C15ull) >> 32; }
+
+	SpatialHashGrid::SpatialHashGrid(float cellSize)
+		: m_CellSize(cellSize), m_InvCellSize(1.0f / cellSize), m_CellMask(0) {}
+
+	SpatialHashGrid::~SpatialHashGrid() {}
+
+	void SpatialHashGrid::FindPossibleCollisions(const BodyStore& bodies,
+												 CollisionList& possibleCollisions) {
+		NT_PROFILE_FUNC();
+
+		possibleCollisions.clear();
+
+		// cache bounds, count how many cells objects will be binned into
+		uint32_t numObjects = bodies.Size();
+		uint32_t numEntries = 0;
+		m_Bounds.resize(numObjects);
+		m_IDs.resize(numObjects);
+		for (uint32_t i = 0; i < numObjects; i++) {
+			m_Bounds[i] = bodies.GetShape(i)->GetAABB();
+			m_IDs[i] = bodies.GetID(i);
+
+			glm::ivec2 min, max;
+			GetCellRange(m_Bounds[i], min, max);
+			numEntries += (max.x - min.x + 1) * (max.y - min.y + 1);
+		}
+
+		// size table so it is at most half full, even if every entry is in a different cell
+		uint32_t capacity = 16;
+		while (capacity < 2 * numEntries)
+			capacity <<= 1;
+
+		m_Cells.resize(capacity);
+		m_CellMask = capacity - 1;
+		for (Cell& cell : m_Cells)
+			cell.count = 0;
+
+		// count objects in each cell
+		for (uint32_t i = 0; i < numObjects; i++) {
+			glm::ivec2 min, max;
+			GetCellRange(m_Bounds[i], min, max);
+
+			for (int32_t x = min.x; x <= max.x; x++)
+				for (int32_t y = min.y; y <= max.y; y++)
+					FindCell(CellKey(x, y)).count++;
+		}
+
+		// give each cell a contiguous range of the object array
+		uint32_t start = 0;
+		for (Cell& cell : m_Cells) {
+			cell.start = start;
+			cell.filled = 0;
+			start += cell.count;
+		}
+
+		m_CellObjects.resize(numEntries);
+		for (uint32_t i = 0; i < numObjects; i++) {
+			glm::ivec2 min, max;
+			GetCellRange(m_Bounds[i], min, max);
+
+			for (int32_t x = min.x; x <= max.x; x++) {
+				for (int32_t y = min.y; y <= max.y; y++) {
+					Cell& cell = FindCell(CellKey(x, y));
+					m_CellObjects[cell.start + cell.filled++] = i;
+				}
+			}
+		}
+
+		// test objects sharing a cell
+		for (const Cell& cell : m_Cells) {
+			if (cell.count < 2)
+				continue;
+
+			int32_t cellX = (int32_t) (cell.key >> 32);
+			int32_t cellY = (int32_t) (cell.key & 0xFFFFFFFF);
+
+			for (uint32_t i = cell.start; i < cell.start + cell.count; i++) {
+				for (uint32_t j = i + 1; j < cell.start + cell.count; j++) {
+					const AABB& A = m_Bounds[m_CellObjects[i]];
+					const AABB& B = m_Bounds[m_CellObjects[j]];
+
+					if (!A.Intersects(B))
+						continue;
+
+					// objects can share many cells, only report them from the cell containing
+					// the lower left corner of their overlap
+					glm::vec2 overlapMin = glm::max(A.min, B.min);
+					if ((int32_t) glm::floor(overlapMin.x * m_InvCellSize) != cellX ||
+						(int32_t) glm::floor(overlapMin.y * m_InvCellSize) != cellY)
+						continue;
+
+					possibleCollisions.push_back(
+						{bodies.GetID(m_CellObjects[i]), bodies.GetID(m_CellObjects[j])});
+				}
+			}
+		}
+	}
+
+	void SpatialHashGrid::Query(const AABB& bounds, std::vector<BodyID>& bodies) {
+		bodies.clear();
+
+		glm::ivec2 min, max;
+		GetCellRange(bounds, min, max);
+
+		// a box covering more cells than there are objects is cheaper to test object by object
+		uint64_t numCells = (uint64_t) (max.x - min.x + 1) * (max.y - min.y + 1);
+		if (m_Cells.empty() || numCells > m_Bounds.size()) {
+			for (uint32_t i = 0; i < m_Bounds.size(); i++) {
+				if (m_Bounds[i].Intersects(bounds))
+					bodies.push_back(m_IDs[i]);
+			}
+			return;
+		}
+
+		for (int32_t x = min.x; x <= max.x; x++) {
+			for (int32_t y = min.y; y <= max.y; y++) {
+				const Cell* cell = LookupCell(CellKey(x, y));
+				if (!cell)
+					continue;
+
+				for (uint32_t i = cell->start; i < cell->start + cell->count; i++) {
+					const AABB& object = m_Bounds[m_CellObjects[i]];
+					if (!object.Intersects(bounds))
+						continue;
+
+					// objects can share many cells with the box, only report them from the cell
+					// containing the lower left corner of their overlap
+					glm::vec2 overlapMin = glm::max(object.min, bounds.min);
+					if ((int32_t) glm::floor(overlapMin.x * m_InvCellSize) != x ||
+						(int32_t) glm::floor(overlapMin.y * m_InvCellSize) != y)
+						continue;
+
+					bodies.push_back(m_IDs[m_CellObjects[i]]);
+				}
+			}
+		}
+	}
+
+	SpatialHashGrid::Cell& SpatialHashGrid::FindCell(uint64_t key) {
+		// linear probing; table is never more than half full, so this always terminates quickly
+		uint32_t slot = HashCell(key) & m_CellMask;
+		while (true) {
+			Cell& cell = m_Cells[slot];
+
+			if (cell.count == 0) {
+				cell.key = key;
+				return cell;
+			}
+
+			if (cell.key == key)
+				return cell;
+
+			slot = (slot + 1) & m_CellMask;
+		}
+	}
+
+	const SpatialHashGrid::Cell* SpatialHashGrid::LookupCell(uint64_t key) const {
+		uint32_t slot = HashCell(key) & m_CellMask;
+		while (m_Cells[slot].count != 0) {
+			if (m_Cells[slot].key == key)
+				return &m_Cells[slot];
+
+			slot = (slot + 1) & m_CellMask;
+		}
+
+		return nullptr;
+	}
+
+	void SpatialHashGrid::GetCellRange(const AABB& bounds, glm::ivec2& min,
+									   glm::ivec2& max) const {
+		min = glm::ivec2(glm::floor(bounds.min * m_InvCellSize));
+		max = glm::ivec2(glm::floor(bounds.max * m_InvCellSize));
+	}
+} // namespace Fizz
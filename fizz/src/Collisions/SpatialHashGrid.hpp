@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Objects/AABB.hpp"
+#include "Objects/BodyStore.hpp"
+#include "BroadPhase.hpp"
+
+namespace Fizz {
+	/* Broad phase that bins objects into a uniform grid of square cells. Only occupied cells are
+	   stored, in a flat open addressing hash table keyed by cell coordinates, so the grid covers
+	   an unbounded world. Objects are binned into every cell their bounding box overlaps, and each
+	   cell's objects are kept contiguously in a single array, so an update does no allocation once
+	   the grid has reached a steady size.
+
+	   This works best when objects are similarly sized, and the cell size is close to the size of
+	   a typical object.
+	 */
+	class SpatialHashGrid : public BroadPhase {
+	  public:
+		/* Creates an empty grid.
+
+		   @param cellSize: The width and height of each cell
+		 */
+		SpatialHashGrid(float cellSize = 1.0f);
+		~SpatialHashGrid();
+
+		virtual void FindPossibleCollisions(const BodyStore& bodies,
+											CollisionList& possibleCollisions) override;
+
+		virtual void Query(const AABB& bounds, std::vector<BodyID>& bodies) override;
+
+		virtual void Remove(BodyID id) override {}
+
+		virtual BroadPhaseType GetType() const override { return BroadPhaseType::SPATIAL_HASH; }
+
+	  private:
+		struct Cell {
+			uint64_t key;
+			// range of this cell's objects in m_CellObjects, a count of 0 marks an empty slot
+			uint32_t start, count;
+			// number of objects written to the range so far
+			uint32_t filled;
+		};
+
+		/* Gets the slot in the hash table holding the given cell, claiming an empty slot for it if
+		   it has not been added yet.
+		 */
+		Cell& FindCell(uint64_t key);
+
+		/* Gets the slot in the hash table holding the given cell, or nullptr if the cell is empty
+		 */
+		const Cell* LookupCell(uint64_t key) const;
+
+		/* Calculates the range of cells covered by a bounding box */
+		void GetCellRange(const AABB& bounds, glm::ivec2& min, glm::ivec2& max) const;
+
+	  private:
+		float m_CellSize;
+		float m_InvCellSize;
+
+		// open addressing hash table of occupied cells, size is always a power of 2
+		std::vector<Cell> m_Cells;
+		uint32_t m_CellMask;
+
+		// object indices, grouped by cell
+		std::vector<uint32_t> m_CellObjects;
+		std::vector<AABB> m_Bounds;
+		// ID of the body at each object index
+		std::vector<BodyID> m_IDs;
+	};
+} // namespace Fizz
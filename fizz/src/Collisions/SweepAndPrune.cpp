@@ -0,0 +1,95 @@
+#include "SweepAndPrune.hpp"
+
+#include <algorithm>
+
+namespace Fizz {
+	SweepAndPrune::SweepAndPrune() : m_MaxLength(0.0f) {}
+
+	SweepAndPrune::~SweepAndPrune() {}
+
+	void SweepAndPrune::FindPossibleCollisions(const BodyStore& bodies,
+											   CollisionList& possibleCollisions) {
+		NT_PROFILE_FUNC();
+
+		// refresh bounds, start tracking new objects
+		for (uint32_t i = 0; i < bodies.Size(); i++) {
+			BodyID id = bodies.GetID(i);
+
+			if (id >= m_Tracked.size()) {
+				m_Tracked.resize(id + 1, false);
+				m_Bounds.resize(id + 1);
+			}
+
+			m_Bounds[id] = bodies.GetShape(i)->GetAABB();
+
+			if (!m_Tracked[id]) {
+				m_Tracked[id] = true;
+				m_Endpoints.push_back({0.0f, 0.0f, id});
+			}
+		}
+
+		m_MaxLength = 0.0f;
+		for (Endpoints& endpoints : m_Endpoints) {
+			endpoints.min = m_Bounds[endpoints.id].min.x;
+			endpoints.max = m_Bounds[endpoints.id].max.x;
+			m_MaxLength = std::max(m_MaxLength, endpoints.max - endpoints.min);
+		}
+
+		Sort();
+
+		// sweep along x axis, only objects with overlapping intervals can be colliding
+		possibleCollisions.clear();
+		for (uint32_t i = 0; i < m_Endpoints.size(); i++) {
+			const Endpoints& A = m_Endpoints[i];
+
+			for (uint32_t j = i + 1; j < m_Endpoints.size(); j++) {
+				const Endpoints& B = m_Endpoints[j];
+				if (B.min > A.max)
+					break;
+
+				if (m_Bounds[A.id].Intersects(m_Bounds[B.id]))
+					possibleCollisions.push_back({A.id, B.id});
+			}
+		}
+	}
+
+	void SweepAndPrune::Query(const AABB& bounds, std::vector<BodyID>& bodies) {
+		bodies.clear();
+
+		// no interval is longer than the longest, so none starting before this can reach the box
+		auto first = std::lower_bound(
+			m_Endpoints.begin(), m_Endpoints.end(), bounds.min.x - m_MaxLength,
+			[](const Endpoints& endpoints, float x) { return endpoints.min < x; });
+
+		for (auto it = first; it != m_Endpoints.end() && it->min <= bounds.max.x; it++) {
+			if (m_Bounds[it->id].Intersects(bounds))
+				bodies.push_back(it->id);
+		}
+	}
+
+	void SweepAndPrune::Remove(BodyID id) {
+		if (id >= m_Tracked.size() || !m_Tracked[id])
+			return;
+
+		m_Tracked[id] = false;
+		m_Endpoints.erase(std::find_if(m_Endpoints.begin(), m_Endpoints.end(),
+									   [id](const Endpoints& e) { return e.id == id; }));
+	}
+
+	void SweepAndPrune::Sort() {
+		NT_PROFILE_FUNC();
+
+		// insertion sort; nearly linear, since order changes very little between updates
+		for (uint32_t i = 1; i < m_Endpoints.size(); i++) {
+			Endpoints key = m_Endpoints[i];
+
+			int32_t j = i - 1;
+			while (j >= 0 && m_Endpoints[j].min > key.min) {
+				m_Endpoints[j + 1] = m_Endpoints[j];
+				j--;
+			}
+
+			m_Endpoints[j + 1] = key;
+		}
+	}
+} // namespace Fizz
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Objects/AABB.hpp"
+#include "Objects/BodyStore.hpp"
+#include "BroadPhase.hpp"
+
+namespace Fizz {
+	/* Sort and sweep broad phase. Objects' bounding boxes are projected onto the x axis, and kept
+	   sorted by their lower endpoint between updates. Since objects move very little from one
+	   update to the next, the array is nearly sorted every time, so it is re-sorted with insertion
+	   sort in close to linear time. Pairs are then found by sweeping along the axis, only testing
+	   objects whose intervals overlap.
+
+	   This works best for scenes with little motion, such as resting stacks, and degrades when
+	   many objects share the same x interval (e.g. a tall column).
+	 */
+	class SweepAndPrune : public BroadPhase {
+	  public:
+		SweepAndPrune();
+		~SweepAndPrune();
+
+		virtual void FindPossibleCollisions(const BodyStore& bodies,
+											CollisionList& possibleCollisions) override;
+
+		virtual void Query(const AABB& bounds, std::vector<BodyID>& bodies) override;
+
+		virtual void Remove(BodyID id) override;
+
+		virtual BroadPhaseType GetType() const override {
+			return BroadPhaseType::SWEEP_AND_PRUNE;
+		}
+
+	  private:
+		struct Endpoints {
+			float min, max;
+			BodyID id;
+		};
+
+		/* Restores the order of m_Endpoints after objects have moved */
+		void Sort();
+
+	  private:
+		// x axis interval of every object, sorted by lower endpoint
+		std::vector<Endpoints> m_Endpoints;
+		// length of the longest interval, bounds how far before a query an overlapping interval
+		// can start
+		float m_MaxLength;
+
+		// per body ID data, refreshed on each update
+		std::vector<AABB> m_Bounds;
+		std::vector<bool> m_Tracked;
+	};
+} // namespace Fizz
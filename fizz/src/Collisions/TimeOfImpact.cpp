@@ -0,0 +1,57 @@
+#include "TimeOfImpact.hpp"
+
+#include "CollisionDispatch.hpp"
+
+namespace Fizz {
+	// gap to leave between shapes at the time of impact, and how close to it counts as there
+	static const float TOI_TARGET = 0.002f;
+	static const float TOI_TOLERANCE = 0.0005f;
+	// cap on advancement steps; the time reached so far is always safe to stop at, see
+	// TOIState::STALLED
+	static const uint32_t MAX_TOI_ITERATIONS = 20;
+
+	TimeOfImpact GetTimeOfImpact(Shape& moving, const Transform& start, const Transform& end,
+								 float radius, const Shape& target) {
+		NT_PROFILE_FUNC();
+
+		glm::vec2 translation = end.position - start.position;
+		float turn = glm::abs(end.rotation - start.rotation);
+		glm::vec2 searchDir =
+			translation == glm::vec2(0.0f, 0.0f) ? glm::vec2(1.0f, 0.0f) : translation;
+
+		TimeOfImpact toi = {TOIState::MISSED, 1.0f, glm::vec2(0.0f), 0.0f};
+		float t = 0.0f;
+		for (uint32_t i = 0; i < MAX_TOI_ITERATIONS; i++) {
+			moving.SetTransform({glm::mix(start.position, end.position, t),
+								 glm::mix(start.rotation, end.rotation, t), end.scale});
+
+			Collision collision = GetCollision(moving, target, searchDir);
+			if (collision.exists) {
+				// advancement never steps past the target, so only the start can overlap
+				TOIState state = i == 0 ? TOIState::OVERLAPPING : TOIState::HIT;
+				return {state, t, collision.MTV, -collision.penetrationDepth};
+			}
+
+			toi = {TOIState::HIT, t, collision.closestDir, collision.separationDist};
+			if (collision.separationDist < TOI_TARGET + TOI_TOLERANCE)
+				return toi;
+
+			// fastest the gap can close: the shape sliding towards the target, plus its furthest
+			// point being swung around by turning
+			float approach = glm::dot(translation, collision.closestDir) + turn * radius;
+			if (approach <= 0.0f)
+				return {TOIState::MISSED, 1.0f, glm::vec2(0.0f), 0.0f};
+
+			t += (collision.separationDist - TOI_TARGET) / approach;
+			if (t >= 1.0f)
+				return {TOIState::MISSED, 1.0f, glm::vec2(0.0f), 0.0f};
+
+			searchDir = collision.closestDir;
+		}
+
+		// out of iterations with the shapes still apart, and not necessarily close: the last time
+		// reached is safe, but is not a time of impact
+		toi.state = TOIState::STALLED;
+		return toi;
+	}
+} // namespace Fizz
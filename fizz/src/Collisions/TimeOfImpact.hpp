@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <Nutella.hpp>
+
+#include "Objects/Shape.hpp"
+
+namespace Fizz {
+	/** The ways a shape sweeping past another can turn out. STALLED means the search ran out of
+	 *  steps while the shapes were still apart, as happens when a shape grazes past another and
+	 *  closes the gap very slowly; the time reached is safe, but the shapes may never meet.
+	 */
+	enum class TOIState { MISSED = 0, HIT, OVERLAPPING, STALLED, COUNT };
+
+	/** Structure describing when (if ever) a moving shape reaches a stationary one */
+	struct TimeOfImpact {
+		TOIState state;
+
+		/** How far through its motion the moving shape first comes within touching distance of
+		 *  the target, from 0 (the start) to 1 (the end). Set if the shapes hit. If the search
+		 *  stalled, the furthest the shape is known to get without touching the target.
+		 */
+		float t;
+
+		/** Direction from the moving shape towards the target at the time of impact. Normalized.
+		 *  Set if the shapes hit or the search stalled.
+		 */
+		glm::vec2 normal;
+
+		/** The gap left between the shapes at the time of impact. Set if the shapes hit or the
+		 *  search stalled.
+		 */
+		float separation;
+	};
+
+	/** Finds the first time a moving shape comes within touching distance of a stationary one,
+	 *  by conservative advancement. The distance between the shapes, and a bound on how quickly
+	 *  the moving shape can close it, give a time the shapes are certain not to have met by.
+	 *  Moving the shape there and repeating converges on the time of impact from below, so a
+	 *  shape is never moved through the target, however thin the target or fast the motion.
+	 *
+	 *  The moving shape travels along a straight line, turning at a constant rate, from its start
+	 *  to its end transform. Its transform is changed along the way, and is left at the last pose
+	 *  tried.
+	 *
+	 *  @param moving: The moving shape
+	 *  @param start: The transform of the moving shape at the start of its motion
+	 *  @param end: The transform of the moving shape at the end of its motion
+	 *  @param radius: The furthest any point of the moving shape is from its position. Bounds
+	 *  how fast turning can move the shape's points.
+	 *  @param target: The stationary shape
+	 *
+	 *  @return When the moving shape reaches the target. Shapes that already overlap at the start
+	 *  are reported as overlapping, and left to regular collision handling.
+	 */
+	TimeOfImpact GetTimeOfImpact(Shape& moving, const Transform& start, const Transform& end,
+								 float radius, const Shape& target);
+} // namespace Fizz
@@ -9,6 +9,7 @@
 #include "Objects/Circle.hpp"
 #include "Collisions/Simplex.hpp"
 #include "PhysicsEnvironment.hpp"
+#include "Rendering/PhysicsRenderer.hpp"
 
 using namespace Nutella;
 using namespace Fizz;
@@ -20,22 +21,18 @@ class FizzLayer : public Layer {
 		  m_CameraController((float) Application::get().getWindow().GetWidth() /
 							 (float) Application::get().getWindow().GetHeight()) {
 
-		// Ref<PhysicsObject> moved = CreateRef<PhysicsObject>(
+		// Ref<PhysicsObject> moved = m_PhysicsEnv.Create(
 		// 	CreateRef<Circle>(0.2),
 		// 	Transform({glm::vec2(0.4f, 0.6f), 0.0f, glm::vec2(0.2f, 0.2f)}));
 
-		// Ref<PhysicsObject> floor = CreateRef<PhysicsObject>(
+		// Ref<PhysicsObject> floor = m_PhysicsEnv.Create(
 		// 	CreateRef<Polygon>(PolygonType::SQUARE),
 		// 	Transform({glm::vec2(0.0f, -0.6f), 0.0f, glm::vec2(1.0f, 0.2f)}));
 		// floor->SetInvMass(0.0f);
 
-		// m_PhysicsEnv.Add(moved);
-		// m_PhysicsEnv.Add(floor);
-
 		srand(time(NULL));
 
 		for (uint32_t i = 0; i < 50; i++) {
-			Ref<PhysicsObject> object;
 			Ref<Shape> shape;
 
 			if (std::rand() % (int) PolygonType::COUNT == 0) {
@@ -52,10 +49,8 @@ class FizzLayer : public Layer {
 			float scaleX = (float) std::rand() / RAND_MAX / 2;
 			float scaleY = (float) std::rand() / RAND_MAX / 2;
 
-			object = CreateRef<PhysicsObject>(
-				shape, Transform({glm::vec2(x, y), rot, glm::vec2(scaleX, scaleY)}));
-
-			m_PhysicsEnv.Add(object);
+			m_PhysicsEnv.Create(shape,
+								Transform({glm::vec2(x, y), rot, glm::vec2(scaleX, scaleY)}));
 		}
 	}
 
@@ -67,13 +62,21 @@ class FizzLayer : public Layer {
 		m_PhysicsEnv.Update(ts);
 
 		Renderer::BeginScene(m_CameraController.GetCamera());
-		m_PhysicsEnv.Render();
+		m_PhysicsRenderer.Render(m_PhysicsEnv);
 		Renderer::EndScene();
 	}
 
 	virtual void OnImGuiRender() override {
 		ImGui::Begin("Fizziks Debug");
 
+		const char* broadPhases[] = {"Quadtree", "Dynamic AABB Tree", "Spatial Hash Grid",
+									 "Sweep and Prune"};
+		int broadPhase = (int) m_PhysicsEnv.GetBroadPhase();
+		if (ImGui::Combo("Broad Phase", &broadPhase, broadPhases, (int) BroadPhaseType::COUNT))
+			m_PhysicsEnv.SetBroadPhase(static_cast<BroadPhaseType>(broadPhase));
+
+		ImGui::Separator();
+
 		Collision collision =
 			GJKGetCollision(m_PhysicsEnv.GetObjects()[0], m_PhysicsEnv.GetObjects()[1]);
 
@@ -113,12 +116,14 @@ class FizzLayer : public Layer {
 
 			ImGui::PushID(i);
 			ImGui::Text("Object %u:", i + 1);
-			ImGui::SliderFloat2("Position", glm::value_ptr(localPos), -2.0f, 2.0f);
-			ImGui::SliderFloat("Rotation", &localRot, 0.0f, 2 * 3.1415f);
-			ImGui::SliderFloat2("Scale", glm::value_ptr(localScale), 0.0f, 2.0f);
+			// only write back what was dragged, writing every frame would keep every body awake
+			bool changed = ImGui::SliderFloat2("Position", glm::value_ptr(localPos), -2.0f, 2.0f);
+			changed |= ImGui::SliderFloat("Rotation", &localRot, 0.0f, 2 * 3.1415f);
+			changed |= ImGui::SliderFloat2("Scale", glm::value_ptr(localScale), 0.0f, 2.0f);
 			ImGui::PopID();
 
-			object->SetTransform(localPos, localRot, localScale);
+			if (changed)
+				object->SetTransform(localPos, localRot, localScale);
 		}
 	}
 
@@ -145,6 +150,7 @@ class FizzLayer : public Layer {
   private:
 	OrthoCamController m_CameraController;
 	PhysicsEnvironment m_PhysicsEnv;
+	PhysicsRenderer m_PhysicsRenderer;
 };
 
 class Sandbox : public Application {
@@ -7,14 +7,39 @@ namespace Fizz {
 	 * (lower left) and maximum (upper right) corners.
 	 */
 	struct AABB {
+		AABB();
 		AABB(const glm::vec2& minVec, const glm::vec2& maxVec);
-		~AABB();
+		~AABB() = default;
 
 		/* Gets the width of this bounding box */
-		inline float GetWidth() { return max.x - min.x; }
+		inline float GetWidth() const { return max.x - min.x; }
 
 		/* Gets the height of this bounding box */
-		inline float GetHeight() { return max.y - min.y; }
+		inline float GetHeight() const { return max.y - min.y; }
+
+		/* Gets the perimeter of this bounding box. Used as the cost metric when building bounding
+		   volume hierarchies.
+		 */
+		inline float GetPerimeter() const { return 2.0f * (GetWidth() + GetHeight()); }
+
+		/* Creates a copy of this bounding box grown by the given margin on every side.
+
+		   @param margin: The distance to move each side of the box outwards
+
+		   @return The expanded bounding box
+		 */
+		inline AABB Expand(float margin) const { return AABB(min - margin, max + margin); }
+
+		/* Creates the smallest bounding box containing both of the given bounding boxes.
+
+		   @param a: The first bounding box
+		   @param b: The second bounding box
+
+		   @return The bounding box containing a and b
+		 */
+		static inline AABB Union(const AABB& a, const AABB& b) {
+			return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max));
+		}
 
 		/* Tests whether this bounding box completely contains the given point. If the point is on
 		   the borders of the box, it is not counted as contained within the box.
@@ -23,7 +48,7 @@ namespace Fizz {
 
 		   @return true if the point is contained in this bounding box, false otherwise
 		 */
-		bool Contains(const glm::vec2& point);
+		bool Contains(const glm::vec2& point) const;
 
 		/* Tests whether this bounding box completely contains the other box.
 
@@ -32,7 +57,7 @@ namespace Fizz {
 		   @return true if the other bounding box is completely contained within this box, false
 		   otherwise
 		 */
-		bool Contains(const AABB& other);
+		bool Contains(const AABB& other) const;
 
 		/* Tests whether any part of this bounding box overlaps with the other bounding box.
 
@@ -40,7 +65,7 @@ namespace Fizz {
 
 		   @return true if this bounding box intersects the other bounding box, false otherwise
 		 */
-		bool Intersects(const AABB& other);
+		bool Intersects(const AABB& other) const;
 
 		glm::vec2 min, max;
 	};
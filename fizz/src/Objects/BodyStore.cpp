@@ -0,0 +1,206 @@
+#include "BodyStore.hpp"
+
+namespace Fizz {
+	BodyStore::BodyStore() {}
+
+	BodyStore::~BodyStore() {}
+
+	BodyID BodyStore::Create(Nutella::Ref<Shape> shape, const Transform& transform,
+							 float density) {
+		BodyID id;
+		if (!m_FreeIDs.empty()) {
+			id = m_FreeIDs.back();
+			m_FreeIDs.pop_back();
+		} else {
+			id = m_Indices.size();
+			m_Indices.push_back(0);
+		}
+
+		m_Indices[id] = m_IDs.size();
+		m_IDs.push_back(id);
+
+		shape->SetTransform(transform);
+		MassInfo massInfo = shape->GetMassInfo(density); // must set transform first
+
+		m_Positions.push_back(transform.position);
+		m_Velocities.push_back(glm::vec2(0.0f));
+		m_Forces.push_back(glm::vec2(0.0f));
+		m_InvMasses.push_back(massInfo.invMass);
+		m_Rotations.push_back(transform.rotation);
+		m_AngularVelocities.push_back(0.0f);
+		m_Torques.push_back(0.0f);
+		m_InvInertias.push_back(massInfo.invRotIntertia);
+		m_Restitutions.push_back(0.8f);
+		m_Frictions.push_back(0.4f);
+		m_Awake.push_back(massInfo.invMass != 0.0f);
+		m_RestFrames.push_back(0);
+
+		m_Scales.push_back(transform.scale);
+		m_PrevPositions.push_back(transform.position);
+		m_PrevRotations.push_back(transform.rotation);
+		m_MassInfos.push_back(massInfo);
+		m_Bullets.push_back(false);
+		m_Shapes.push_back(shape);
+
+		return id;
+	}
+
+	/** Moves the last element of an array into the given index, then shrinks the array */
+	template <typename T> static void SwapRemove(std::vector<T>& array, uint32_t index) {
+		array[index] = std::move(array.back());
+		array.pop_back();
+	}
+
+	void BodyStore::Destroy(BodyID id) {
+		uint32_t index = m_Indices[id];
+		NT_ASSERT(index < m_IDs.size() && m_IDs[index] == id, "Destroying nonexistent body!");
+
+		SwapRemove(m_Positions, index);
+		SwapRemove(m_Velocities, index);
+		SwapRemove(m_Forces, index);
+		SwapRemove(m_InvMasses, index);
+		SwapRemove(m_Rotations, index);
+		SwapRemove(m_AngularVelocities, index);
+		SwapRemove(m_Torques, index);
+		SwapRemove(m_InvInertias, index);
+		SwapRemove(m_Restitutions, index);
+		SwapRemove(m_Frictions, index);
+		SwapRemove(m_Awake, index);
+		SwapRemove(m_RestFrames, index);
+
+		SwapRemove(m_Scales, index);
+		SwapRemove(m_PrevPositions, index);
+		SwapRemove(m_PrevRotations, index);
+		SwapRemove(m_MassInfos, index);
+		SwapRemove(m_Bullets, index);
+		SwapRemove(m_Shapes, index);
+
+		// body that was last is now at the destroyed body's index
+		SwapRemove(m_IDs, index);
+		if (index < m_IDs.size())
+			m_Indices[m_IDs[index]] = index;
+
+		m_FreeIDs.push_back(id);
+	}
+
+	void BodyStore::IntegrateVelocities(float ts, const glm::vec2& gravity, uint32_t begin,
+										uint32_t end) {
+		NT_PROFILE_FUNC();
+
+		glm::vec2* velocities = m_Velocities.data();
+		glm::vec2* forces = m_Forces.data();
+		const float* invMasses = m_InvMasses.data();
+		float* angularVelocities = m_AngularVelocities.data();
+		float* torques = m_Torques.data();
+		const float* invInertias = m_InvInertias.data();
+		const uint8_t* awake = m_Awake.data();
+
+		// symplectic Euler integration, velocity half. Sleeping bodies have no forces, so they
+		// only need gravity masked off, as do static bodies; keeping the loop free of branches
+		// lets it vectorize.
+		for (uint32_t i = begin; i < end; i++) {
+			float active = awake[i] * (float) (invMasses[i] != 0.0f);
+			velocities[i] += (gravity * active + forces[i] * invMasses[i]) * ts;
+			angularVelocities[i] += torques[i] * invInertias[i] * ts;
+
+			// zero out forces for next run loop
+			forces[i] = glm::vec2(0.0f);
+			torques[i] = 0.0f;
+		}
+	}
+
+	void BodyStore::IntegratePositions(float ts, uint32_t begin, uint32_t end) {
+		NT_PROFILE_FUNC();
+
+		glm::vec2* positions = m_Positions.data();
+		float* rotations = m_Rotations.data();
+		const glm::vec2* velocities = m_Velocities.data();
+		const float* angularVelocities = m_AngularVelocities.data();
+		const uint8_t* awake = m_Awake.data();
+
+		// symplectic Euler integration, position half (uses the new velocity)
+		for (uint32_t i = begin; i < end; i++) {
+			float step = awake[i] * ts;
+			positions[i] += velocities[i] * step;
+			rotations[i] += angularVelocities[i] * step;
+		}
+	}
+
+	void BodyStore::SaveTransforms() {
+		NT_PROFILE_FUNC();
+
+		// assignment reuses the existing storage
+		m_PrevPositions = m_Positions;
+		m_PrevRotations = m_Rotations;
+	}
+
+	void BodyStore::UpdateShapes(uint32_t begin, uint32_t end) {
+		NT_PROFILE_FUNC();
+
+		// shapes are checked for collisions from several threads at once, so they must be
+		// brought up to date here rather than by the first check. Sleeping bodies can still have
+		// been moved by hand.
+		for (uint32_t i = begin; i < end; i++) {
+			if (m_Awake[i])
+				m_Shapes[i]->SetTransform(GetTransform(i));
+			m_Shapes[i]->UpdateCache();
+		}
+	}
+
+	Transform BodyStore::GetInterpolatedTransform(uint32_t index, float alpha) const {
+		// rotations are never wrapped, so blending the angle always turns the short way
+		return {glm::mix(m_PrevPositions[index], m_Positions[index], alpha),
+				glm::mix(m_PrevRotations[index], m_Rotations[index], alpha), m_Scales[index]};
+	}
+
+	void BodyStore::SetTransform(uint32_t index, const Transform& transform) {
+		// setting the pose a body already has is not a move, so it neither wakes the body nor
+		// breaks up its blending
+		if (transform.position == m_Positions[index] && transform.rotation == m_Rotations[index] &&
+			transform.scale == m_Scales[index])
+			return;
+
+		m_Positions[index] = transform.position;
+		m_Rotations[index] = transform.rotation;
+		m_PrevPositions[index] = transform.position;
+		m_PrevRotations[index] = transform.rotation;
+		m_Scales[index] = transform.scale;
+		m_Shapes[index]->SetTransform(transform);
+		Wake(index);
+	}
+
+	void BodyStore::Place(uint32_t index, const glm::vec2& position, float rotation) {
+		m_Positions[index] = position;
+		m_Rotations[index] = rotation;
+		m_Shapes[index]->SetTransform(GetTransform(index));
+	}
+
+	void BodyStore::SetInvMass(uint32_t index, float invMass) {
+		// keep the ratio of inertia to mass, which only depends on the shape. Shapes without area
+		// (segments) have no ratio to keep, and never turn.
+		MassInfo& massInfo = m_MassInfos[index];
+		m_InvMasses[index] = invMass;
+		m_InvInertias[index] =
+			massInfo.rotInertia > 0.0f ? invMass * massInfo.mass / massInfo.rotInertia : 0.0f;
+		massInfo.invMass = invMass;
+		massInfo.invRotIntertia = m_InvInertias[index];
+
+		if (invMass == 0.0f)
+			Sleep(index);
+		else
+			Wake(index);
+	}
+
+	void BodyStore::Sleep(uint32_t index) {
+		m_Awake[index] = false;
+		m_RestFrames[index] = 0;
+		m_Velocities[index] = glm::vec2(0.0f);
+		m_Forces[index] = glm::vec2(0.0f);
+		m_AngularVelocities[index] = 0.0f;
+		m_Torques[index] = 0.0f;
+
+		// the solver may have moved the body since its shape was last updated, and UpdateShapes
+		// skips sleeping bodies
+		m_Shapes[index]->SetTransform(GetTransform(index));
+	}
+} // namespace Fizz
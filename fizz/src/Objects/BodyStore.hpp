@@ -0,0 +1,247 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <Nutella.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "Objects/Shape.hpp"
+
+namespace Fizz {
+	/** Stable identifier for a body in a BodyStore. An ID remains valid (and keeps referring to the
+	 *  same body) until that body is destroyed, no matter how many other bodies are created or
+	 *  destroyed in the meantime.
+	 */
+	using BodyID = uint32_t;
+
+	/** Contiguous storage for the state of every body in a physics environment. Each piece of state
+	 *  is kept in its own tightly packed array (structure of arrays), so that stepping the
+	 *  simulation is a linear sweep over memory rather than a walk over individually allocated
+	 *  objects.
+	 *
+	 *  Bodies are addressed in two ways. Their index is the position of their data in the arrays.
+	 *  Indices are dense, but change when other bodies are destroyed. Their ID is stable, and is
+	 *  mapped to their current index by the store.
+	 */
+	class BodyStore {
+	  public:
+		BodyStore();
+		~BodyStore();
+
+		/** Adds a new body to the store.
+		 *
+		 *  @param shape: The shape of the body
+		 *  @param transform: The initial position, rotation, and scale of the body
+		 *  @param density: The density of the body, used to calculate its mass
+		 *
+		 *  @return The ID of the new body
+		 */
+		BodyID Create(Nutella::Ref<Shape> shape, const Transform& transform, float density);
+
+		/** Removes a body from the store. The last body in the store is moved into the slot the
+		 *  destroyed body occupied, so its index changes.
+		 *
+		 *  @param id: The ID of the body to remove
+		 */
+		void Destroy(BodyID id);
+
+		/** Advances the linear and angular velocity of every awake body according to gravity and
+		 *  the forces and torques acting on it, then clears the accumulated forces and torques.
+		 *
+		 *  @param ts: The timestep to integrate over
+		 *  @param gravity: Acceleration applied to every body with finite mass
+		 */
+		inline void IntegrateVelocities(float ts, const glm::vec2& gravity) {
+			IntegrateVelocities(ts, gravity, 0, Size());
+		}
+
+		/** Integrates the velocities of the bodies with indices in [begin, end). Disjoint ranges
+		 *  may be integrated concurrently.
+		 *
+		 *  @param ts: The timestep to integrate over
+		 *  @param gravity: Acceleration applied to every body with finite mass
+		 *  @param begin: The index of the first body to integrate
+		 *  @param end: One past the index of the last body to integrate
+		 */
+		void IntegrateVelocities(float ts, const glm::vec2& gravity, uint32_t begin, uint32_t end);
+
+		/** Advances the position and rotation of every awake body according to its linear and
+		 *  angular velocity. Velocities are
+		 *  integrated first and positions last, with contacts solved in between, so that bodies
+		 *  never move with a velocity the solver has not seen.
+		 *
+		 *  @param ts: The timestep to integrate over
+		 */
+		inline void IntegratePositions(float ts) { IntegratePositions(ts, 0, Size()); }
+
+		/** Integrates the positions of the bodies with indices in [begin, end). Disjoint ranges
+		 *  may be integrated concurrently.
+		 *
+		 *  @param ts: The timestep to integrate over
+		 *  @param begin: The index of the first body to integrate
+		 *  @param end: One past the index of the last body to integrate
+		 */
+		void IntegratePositions(float ts, uint32_t begin, uint32_t end);
+
+		/** Remembers the current transform of every body, so that bodies can be drawn partway
+		 *  between it and wherever they are moved next. See GetInterpolatedTransform.
+		 */
+		void SaveTransforms();
+
+		/** Pushes the transform of every awake body to its shape, and brings every shape's cached
+		 *  data up to date (see Shape::UpdateCache). Must be called after bodies are moved in bulk
+		 *  (e.g. by IntegratePositions) and before any collision checks. Sleeping bodies do not
+		 *  move, so their shapes already have the right transform.
+		 */
+		inline void UpdateShapes() { UpdateShapes(0, Size()); }
+
+		/** Updates the shapes of the bodies with indices in [begin, end). Disjoint ranges may be
+		 *  updated concurrently.
+		 *
+		 *  @param begin: The index of the first body to update
+		 *  @param end: One past the index of the last body to update
+		 */
+		void UpdateShapes(uint32_t begin, uint32_t end);
+
+		/** Gets the number of bodies in the store */
+		inline uint32_t Size() const { return m_IDs.size(); }
+
+		/** Gets the current index of the body with the given ID */
+		inline uint32_t GetIndex(BodyID id) const { return m_Indices[id]; }
+		/** Gets the ID of the body at the given index */
+		inline BodyID GetID(uint32_t index) const { return m_IDs[index]; }
+
+		inline const glm::vec2& GetPosition(uint32_t index) const { return m_Positions[index]; }
+		inline float GetRotation(uint32_t index) const { return m_Rotations[index]; }
+		inline const glm::vec2& GetScale(uint32_t index) const { return m_Scales[index]; }
+		inline Transform GetTransform(uint32_t index) const {
+			return {m_Positions[index], m_Rotations[index], m_Scales[index]};
+		}
+		/** Blends between the transform a body had when SaveTransforms was last called and the
+		 *  one it has now, so a body can be drawn between two fixed steps.
+		 *
+		 *  @param index: The index of the body
+		 *  @param alpha: How far to blend, from 0 (the saved transform) to 1 (the current one)
+		 *
+		 *  @return The blended transform
+		 */
+		Transform GetInterpolatedTransform(uint32_t index, float alpha) const;
+		/** Gets the transform a body had when SaveTransforms was last called */
+		inline Transform GetSavedTransform(uint32_t index) const {
+			return {m_PrevPositions[index], m_PrevRotations[index], m_Scales[index]};
+		}
+		/** Moves a body to a new transform, waking it if it is asleep. The body is not blended
+		 *  from its old transform. Setting the transform a body already has does nothing.
+		 */
+		void SetTransform(uint32_t index, const Transform& transform);
+		/** Moves a body and its shape as part of the simulation. Unlike SetTransform, the body
+		 *  is not woken, and is still blended from its saved transform when drawn.
+		 */
+		void Place(uint32_t index, const glm::vec2& position, float rotation);
+		/** Moves a body without updating its shape. UpdateShapes must be called before the body
+		 *  is checked for collisions.
+		 */
+		inline void AddPosition(uint32_t index, const glm::vec2& dp) { m_Positions[index] += dp; }
+
+		inline const glm::vec2& GetVelocity(uint32_t index) const { return m_Velocities[index]; }
+		inline void AddVelocity(uint32_t index, const glm::vec2& dv) { m_Velocities[index] += dv; }
+
+		/** Gets the angular velocity of a body, in radians per second counter-clockwise */
+		inline float GetAngularVelocity(uint32_t index) const { return m_AngularVelocities[index]; }
+		inline void AddAngularVelocity(uint32_t index, float dw) {
+			m_AngularVelocities[index] += dw;
+		}
+
+		/** Adds a force to a body, waking it if it is asleep */
+		inline void AddForce(uint32_t index, const glm::vec2& force) {
+			Wake(index);
+			m_Forces[index] += force;
+		}
+
+		/** Adds a torque to a body, waking it if it is asleep */
+		inline void AddTorque(uint32_t index, float torque) {
+			Wake(index);
+			m_Torques[index] += torque;
+		}
+
+		inline float GetInvMass(uint32_t index) const { return m_InvMasses[index]; }
+		/** Sets the inverse mass of a body. The inverse rotational inertia is scaled along with
+		 *  it, so the body keeps its shape's mass distribution. Bodies with an inverse mass of 0
+		 *  are static: nothing pushes them, and they are only awake while they have a velocity
+		 *  of their own (see Wake). Making a body static stops it, and giving a static body mass
+		 *  wakes it.
+		 */
+		void SetInvMass(uint32_t index, float invMass);
+
+		/** Checks whether a body is simulated. Sleeping (and static) bodies are not integrated,
+		 *  and pairs of them are not checked for collisions.
+		 */
+		inline bool IsAwake(uint32_t index) const { return m_Awake[index]; }
+		/** Wakes a body, if it is asleep. Static bodies are only woken if they are moving, and
+		 *  then move at a constant velocity without being pushed or pulled by gravity.
+		 */
+		inline void Wake(uint32_t index) {
+			bool moving =
+				m_Velocities[index] != glm::vec2(0.0f) || m_AngularVelocities[index] != 0.0f;
+			if (!m_Awake[index] && (m_InvMasses[index] != 0.0f || moving)) {
+				m_Awake[index] = true;
+				m_RestFrames[index] = 0;
+			}
+		}
+		/** Puts a body to sleep, stopping it in place. Its shape is moved to where it stops. */
+		void Sleep(uint32_t index);
+
+		/** Gets the number of consecutive updates a body has been resting for, see Islands */
+		inline uint32_t GetRestFrames(uint32_t index) const { return m_RestFrames[index]; }
+		inline void SetRestFrames(uint32_t index, uint32_t frames) { m_RestFrames[index] = frames; }
+		inline float GetInvInertia(uint32_t index) const { return m_InvInertias[index]; }
+		inline const MassInfo& GetMassInfo(uint32_t index) const { return m_MassInfos[index]; }
+
+		inline float GetRestitution(uint32_t index) const { return m_Restitutions[index]; }
+		inline void SetRestitution(uint32_t index, float restitution) {
+			m_Restitutions[index] = restitution;
+		}
+
+		/** Gets the friction coefficient of a body's surface */
+		inline float GetFriction(uint32_t index) const { return m_Frictions[index]; }
+		inline void SetFriction(uint32_t index, float friction) { m_Frictions[index] = friction; }
+
+		/** Checks whether a body is swept for collisions along its motion, rather than only
+		 *  checked where each step leaves it. See PhysicsObject::SetBullet.
+		 */
+		inline bool IsBullet(uint32_t index) const { return m_Bullets[index]; }
+		inline void SetBullet(uint32_t index, bool bullet) { m_Bullets[index] = bullet; }
+
+		inline const Nutella::Ref<Shape>& GetShape(uint32_t index) const { return m_Shapes[index]; }
+
+	  private:
+		// hot state, touched every step
+		std::vector<glm::vec2> m_Positions;
+		std::vector<glm::vec2> m_Velocities;
+		std::vector<glm::vec2> m_Forces;
+		std::vector<float> m_InvMasses;
+		std::vector<float> m_Rotations;
+		std::vector<float> m_AngularVelocities;
+		std::vector<float> m_Torques;
+		std::vector<float> m_InvInertias;
+		std::vector<float> m_Restitutions;
+		std::vector<float> m_Frictions;
+		std::vector<uint8_t> m_Awake;
+		std::vector<uint32_t> m_RestFrames;
+
+		// cold state, only needed when transforms change or for mass queries
+		std::vector<glm::vec2> m_Scales;
+		// transform saved by SaveTransforms, for drawing between steps
+		std::vector<glm::vec2> m_PrevPositions;
+		std::vector<float> m_PrevRotations;
+		std::vector<MassInfo> m_MassInfos;
+		std::vector<uint8_t> m_Bullets;
+		std::vector<Nutella::Ref<Shape>> m_Shapes;
+
+		// ID <-> index mapping
+		std::vector<BodyID> m_IDs;		 // index -> ID
+		std::vector<uint32_t> m_Indices; // ID -> index
+		std::vector<BodyID> m_FreeIDs;	 // IDs of destroyed bodies, ready for reuse
+	};
+} // namespace Fizz
@@ -0,0 +1,55 @@
+#include "Capsule.hpp"
+
+namespace Fizz {
+	Capsule::Capsule(float halfLength, float radius)
+		: m_Points {glm::vec2(-halfLength, 0.0f), glm::vec2(halfLength, 0.0f)},
+		  m_HalfLength(halfLength), m_Radius(radius) {}
+
+	Capsule::~Capsule() {}
+
+	glm::vec2 Capsule::Support(const glm::vec2& dir) const {
+		// support of the core, pushed out by the radius like a circle's
+		const glm::vec2& core =
+			glm::dot(m_Points[1] - m_Points[0], dir) > 0.0f ? m_Points[1] : m_Points[0];
+		return core + dir * (m_Radius * glm::inversesqrt(glm::dot(dir, dir)));
+	}
+
+	AABB Capsule::GetAABB() const {
+		glm::vec2 min = glm::min(m_Points[0], m_Points[1]) - m_Radius;
+		glm::vec2 max = glm::max(m_Points[0], m_Points[1]) + m_Radius;
+		return {min, max};
+	}
+
+	void Capsule::SetTransform(const Transform& transform) {
+		m_HalfLength = transform.scale.x;
+		m_Radius = transform.scale.y;
+
+		glm::vec2 axis =
+			m_HalfLength * glm::vec2(glm::cos(transform.rotation), glm::sin(transform.rotation));
+		m_Points[0] = transform.position - axis;
+		m_Points[1] = transform.position + axis;
+	}
+
+	MassInfo Capsule::GetMassInfo(const float density) {
+		float pi = 3.141592f;
+
+		// a rectangle around the core, plus a circle split between the two ends
+		float rectMass = 4.0f * m_HalfLength * m_Radius * density;
+		float circleMass = pi * m_Radius * m_Radius * density;
+		float mass = rectMass + circleMass;
+		float invMass = 1.0f / mass;
+
+		// each half circle is moved out to its end of the core, measured from the centroid of the
+		// half circle (4r / 3pi from its flat side) with the parallel axis theorem
+		float halfCircleOffset = 4.0f * m_Radius / (3.0f * pi);
+		float rectInertia =
+			rectMass * (4.0f * m_HalfLength * m_HalfLength + 4.0f * m_Radius * m_Radius) / 12.0f;
+		float circleInertia =
+			circleMass * (m_Radius * m_Radius / 2.0f + m_HalfLength * m_HalfLength +
+						  2.0f * m_HalfLength * halfCircleOffset);
+		float rotInertia = rectInertia + circleInertia;
+		float invRotInertia = 1.0f / rotInertia;
+
+		return {density, mass, invMass, rotInertia, invRotInertia};
+	}
+} // namespace Fizz
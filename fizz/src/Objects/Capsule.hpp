@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Shape.hpp"
+
+namespace Fizz {
+	/** A rectangle with a half circle on each end; every point within a fixed radius of a line
+	 *  segment (the capsule's core). The core lies along the capsule's local x axis, centered on
+	 *  its position.
+	 *
+	 *  Like a circle, a capsule takes its size from its transform: scale.x is half the length of
+	 *  the core, and scale.y is the radius. A capsule scaled like a square therefore fits inside
+	 *  that square's bounds stretched by the radius at each end.
+	 */
+	class Capsule : public Shape {
+	  public:
+		Capsule(float halfLength, float radius);
+		~Capsule();
+
+		virtual ShapeType GetType() const override { return ShapeType::CAPSULE; }
+
+		virtual glm::vec2 Support(const glm::vec2& dir) const override;
+		virtual AABB GetAABB() const override;
+
+		virtual void SetTransform(const Transform& transform) override;
+
+		virtual MassInfo GetMassInfo(const float density) override;
+
+		/** Gets the ends of the core with the transform applied */
+		inline const glm::vec2& GetStart() const { return m_Points[0]; }
+		inline const glm::vec2& GetEnd() const { return m_Points[1]; }
+
+		/** Gets both ends of the core, start first, as an array */
+		inline const glm::vec2* GetPoints() const { return m_Points; }
+
+		inline float GetHalfLength() const { return m_HalfLength; }
+		inline float GetRadius() const { return m_Radius; }
+
+	  private:
+		glm::vec2 m_Points[2];
+		float m_HalfLength;
+		float m_Radius;
+	};
+} // namespace Fizz
@@ -1,8 +1,5 @@
 #pragma once
 
-#include <Nutella/Renderer/VertexArray.hpp>
-#include <Nutella/Renderer/Shader.hpp>
-
 #include "Shape.hpp"
 
 namespace Fizz {
@@ -11,7 +8,7 @@ namespace Fizz {
 		Circle(float radius);
 		~Circle();
 
-		virtual void Render() override;
+		virtual ShapeType GetType() const override { return ShapeType::CIRCLE; }
 
 		virtual glm::vec2 Support(const glm::vec2& dir) const override;
 		virtual AABB GetAABB() const override;
@@ -20,13 +17,11 @@ namespace Fizz {
 
 		virtual MassInfo GetMassInfo(const float density) override;
 
+		inline const glm::vec2& GetPosition() const { return m_Position; }
+		inline float GetRadius() const { return m_Radius; }
+
 	  private:
 		glm::vec2 m_Position;
 		float m_Radius;
-
-		glm::mat4 m_TRSMat;
-		Nutella::Ref<Nutella::VertexArray> m_VAO;
-		// TODO: this should be shared between instances
-		Nutella::Ref<Nutella::Shader> m_Shader;
 	};
 } // namespace Fizz
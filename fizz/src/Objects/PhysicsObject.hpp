@@ -4,83 +4,121 @@
 #include <Nutella.hpp>
 
 #include "Objects/Shape.hpp"
+#include "Objects/BodyStore.hpp"
 
 namespace Fizz {
 	/** Represents a physics object. Objects can move, collide, and interact with each other in a
 	 *  physics environment.
+	 *
+	 *  A physics object is a lightweight handle to a body in the BodyStore of the environment that
+	 *  created it; all of its state lives in the store. Objects must not outlive their environment.
 	 */
 	class PhysicsObject {
 	  public:
-		PhysicsObject(Nutella::Ref<Shape> shape,
-					  Transform transform = {glm::vec2(0.0f, 0.0f), 0.0f, glm::vec2(0.2f, 0.2f)},
-					  float density = 1.0f);
+		PhysicsObject(BodyStore& store, BodyID id);
 
-		/** Updates the position of the physics object according to its velocity and acceleration.
-		 *
-		 *  @param ts: The timestep to use when updating
-		 */
-		void Update(Nutella::Timestep ts);
-
-		/** Renders the physics object on the screen */
-		void Render();
-
-		/** Immediately changes velocity by the full size of the given impulse vector.
+		/** Immediately changes velocity by the full size of the given impulse vector. Wakes the
+		 *  object if it is asleep.
 		 *
 		 *  @param impulse: The impulse vector to add to the velocity
 		 */
-		inline void ApplyImpulse(const glm::vec2& impulse) { m_Velocity += impulse; }
+		inline void ApplyImpulse(const glm::vec2& impulse) {
+			m_Store->AddVelocity(Index(), impulse);
+			m_Store->Wake(Index());
+		}
 
 		/** Adds an force to the object. When this object is updated, the object's velocity will be
 		 *  changed by a portion of the force vector proportional to the inverse mass of the object
-		 *  and the timestep used to update it.
+		 *  and the timestep used to update it. Wakes the object if it is asleep.
 		 *
 		 *  @param force: The force vector to add to the object
 		 */
-		inline void ApplyForce(const glm::vec2& force) { m_Force += force; }
+		inline void ApplyForce(const glm::vec2& force) { m_Store->AddForce(Index(), force); }
 
-		inline const glm::vec2& GetPos() const { return m_Transform.position; }
-		inline void SetPos(const glm::vec2& position) {
-			m_Transform.position = position;
-			m_Shape->SetTransform(m_Transform);
-		}
-		inline float GetRot() const { return m_Transform.rotation; }
-		inline void SetRot(float rotation) {
-			m_Transform.rotation = rotation;
-			m_Shape->SetTransform(m_Transform);
+		/** Immediately changes angular velocity by the given amount. Wakes the object if it is
+		 *  asleep.
+		 *
+		 *  @param impulse: The change in angular velocity, in radians per second
+		 *  counter-clockwise
+		 */
+		inline void ApplyAngularImpulse(float impulse) {
+			m_Store->AddAngularVelocity(Index(), impulse);
+			m_Store->Wake(Index());
 		}
-		inline const glm::vec2& GetScale() const { return m_Transform.scale; }
-		inline void SetScale(const glm::vec2& scale) {
-			m_Transform.scale = scale;
-			m_Shape->SetTransform(m_Transform);
+
+		/** Adds a torque to the object. When this object is updated, its angular velocity will be
+		 *  changed by the torque scaled by the inverse rotational inertia of the object and the
+		 *  timestep used to update it. Wakes the object if it is asleep.
+		 *
+		 *  @param torque: The counter-clockwise torque to add to the object
+		 */
+		inline void ApplyTorque(float torque) { m_Store->AddTorque(Index(), torque); }
+
+		inline const glm::vec2& GetPos() const { return m_Store->GetPosition(Index()); }
+		inline void SetPos(const glm::vec2& position) {
+			SetTransform(position, GetRot(), GetScale());
 		}
+		inline float GetRot() const { return m_Store->GetRotation(Index()); }
+		inline void SetRot(float rotation) { SetTransform(GetPos(), rotation, GetScale()); }
+		inline const glm::vec2& GetScale() const { return m_Store->GetScale(Index()); }
+		inline void SetScale(const glm::vec2& scale) { SetTransform(GetPos(), GetRot(), scale); }
 		inline void SetTransform(const Transform& transform) {
-			m_Transform = transform;
-			m_Shape->SetTransform(m_Transform);
+			m_Store->SetTransform(Index(), transform);
 		}
 		inline void SetTransform(const glm::vec2& pos, const float rot, const glm::vec2& scale) {
-			m_Transform = {pos, rot, scale};
-			m_Shape->SetTransform(m_Transform);
+			m_Store->SetTransform(Index(), {pos, rot, scale});
 		}
 
-		inline const glm::vec2& GetVelocity() const { return m_Velocity; }
+		/** Gets the transform to draw the object with, partway between its last two fixed steps.
+		 *  See PhysicsEnvironment::GetInterpolationAlpha.
+		 *
+		 *  @param alpha: How far to blend, from 0 (the step before last) to 1 (the last step)
+		 */
+		inline Transform GetInterpolatedTransform(float alpha) const {
+			return m_Store->GetInterpolatedTransform(Index(), alpha);
+		}
 
-		inline float GetInvMass() const { return m_MassInfo.invMass; }
-		inline void SetInvMass(float invMass) { m_MassInfo.invMass = invMass; }
-		inline float GetRestitution() const { return m_Restitution; }
-		inline void SetRestitution(float restitution) { m_Restitution = restitution; }
+		inline const glm::vec2& GetVelocity() const { return m_Store->GetVelocity(Index()); }
+		inline float GetAngularVelocity() const { return m_Store->GetAngularVelocity(Index()); }
 
-		/** Gets the shape that this physics object uses for collision checks and rendering */
-		inline Nutella::Ref<Shape> GetShape() const { return m_Shape; }
+		/** Checks whether the object is being simulated. Objects fall asleep once they and
+		 *  everything touching them come to rest, and wake when something hits them, or when they
+		 *  are pushed or moved by hand.
+		 */
+		inline bool IsAwake() const { return m_Store->IsAwake(Index()); }
+		inline void Wake() { m_Store->Wake(Index()); }
 
-	  private:
-		Nutella::Ref<Shape> m_Shape;
-		Transform m_Transform;
+		/** Sets whether the object is a bullet. Objects are normally only checked for collisions
+		 *  where each step leaves them, so small, fast objects can pass straight through thin
+		 *  ones between two steps. Bullets are instead swept along their motion, and stopped
+		 *  where they first hit something. Sweeping costs more, so only fast objects should be
+		 *  bullets.
+		 *
+		 *  @param bullet: Whether the object is a bullet
+		 */
+		inline void SetBullet(bool bullet) { m_Store->SetBullet(Index(), bullet); }
+		inline bool IsBullet() const { return m_Store->IsBullet(Index()); }
+
+		inline float GetInvMass() const { return m_Store->GetInvMass(Index()); }
+		inline void SetInvMass(float invMass) { m_Store->SetInvMass(Index(), invMass); }
+		inline float GetRestitution() const { return m_Store->GetRestitution(Index()); }
+		inline void SetRestitution(float restitution) {
+			m_Store->SetRestitution(Index(), restitution);
+		}
+		inline float GetFriction() const { return m_Store->GetFriction(Index()); }
+		inline void SetFriction(float friction) { m_Store->SetFriction(Index(), friction); }
 
-		glm::vec2 m_Velocity;
-		glm::vec2 m_Force;
+		/** Gets the shape that this physics object uses for collision checks */
+		inline const Nutella::Ref<Shape>& GetShape() const { return m_Store->GetShape(Index()); }
 
-		MassInfo m_MassInfo;
+		/** Gets the ID of the body this object refers to in its environment's body store */
+		inline BodyID GetID() const { return m_ID; }
 
-		float m_Restitution;
+	  private:
+		inline uint32_t Index() const { return m_Store->GetIndex(m_ID); }
+
+	  private:
+		BodyStore* m_Store;
+		BodyID m_ID;
 	};
 } // namespace Fizz
@@ -1,143 +1,348 @@
 #include "Polygon.hpp"
 
-#include <glm/gtc/matrix_transform.hpp>
-#include <Nutella/Renderer/Renderer.hpp>
+#include <Nutella.hpp>
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define FIZZ_SUPPORT_SSE
+	#include <xmmintrin.h>
+#endif
 
 namespace Fizz {
-	using namespace Nutella;
+	// number of vertices tested at once by the vectorized support query
+	static constexpr uint32_t SUPPORT_SIMD_WIDTH = 4;
 
-	Polygon::Polygon(const std::vector<glm::vec2>& points)
-		: m_Points(points), m_NumPoints(points.size()),
-		  m_Shader(Shader::Create("fizz/res/shaders/Mesh.shader")) {
-		// use point data to create a Vertex Array
-		VertexBufferLayout layout;
-		layout.push(VertexAttribType::FLOAT, 2, false); // position
-
-		Ref<VertexBuffer> vbo;
-		vbo = VertexBuffer::Create(&m_Points[0], 2 * m_NumPoints * sizeof(float));
-
-		unsigned int vertexOrder[3 * (m_NumPoints - 2)];
-		for (unsigned int i = 0; i < m_NumPoints - 2; i++) {
-			vertexOrder[3 * i] = 0;
-			vertexOrder[3 * i + 1] = i + 1;
-			vertexOrder[3 * i + 2] = i + 2;
-		}
+	// polygons with at least this many vertices find support points by hill climbing. Below this,
+	// testing every vertex is faster even when the last support point is a good starting guess.
+	static constexpr uint32_t HILL_CLIMB_MIN_POINTS = 32;
+
+	// smallest turn (the sine of the angle between neighbouring edges) kept as a corner of a
+	// convex hull. Flatter corners cost a vertex without visibly changing the shape.
+	static const float HULL_MIN_TURN = 0.0001f;
 
-		Ref<IndexBuffer> ibo;
-		ibo = IndexBuffer::Create(vertexOrder, sizeof(vertexOrder));
+	/** Gets the z component of the cross product of two vectors in the plane */
+	static inline float Cross(const glm::vec2& a, const glm::vec2& b) {
+		return a.x * b.y - a.y * b.x;
+	}
 
-		m_VAO = VertexArray::Create(layout, vbo, ibo);
+	/** Checks that points form a convex polygon with counter-clockwise winding */
+	static bool IsConvex(const std::vector<glm::vec2>& points) {
+		uint32_t numPoints = points.size();
+		if (numPoints < 3)
+			return false;
+
+		for (uint32_t i = 0; i < numPoints; i++) {
+			const glm::vec2& a = points[i];
+			const glm::vec2& b = points[(i + 1) % numPoints];
+			const glm::vec2& c = points[(i + 2) % numPoints];
+			if (Cross(b - a, c - b) < 0.0f)
+				return false;
+		}
 
-		m_TransformedPoints.resize(m_NumPoints);
+		return true;
 	}
 
-	Polygon::Polygon(PolygonType type) : m_Shader(Shader::Create("fizz/res/shaders/Mesh.shader")) {
-		std::vector<uint32_t> vertexOrder;
+	PolygonGeometry::PolygonGeometry(const std::vector<glm::vec2>& points) : m_Points(points) {
+		// fan triangulation, support hill climbing, and the separating axis test all rely on this
+		NT_ASSERT(IsConvex(points), "Polygon must be convex with counter-clockwise winding!");
+	}
 
+	/** Builds the local vertices of a regular polygon type, with unit circumradius */
+	static std::vector<glm::vec2> RegularPoints(PolygonType type) {
 		float halfSqrt3 = glm::sqrt(3) / 2;
 
 		switch (type) {
 		case PolygonType::TRIANGLE:
-			m_NumPoints = 3;
-			m_Points = {{-1.0f, -halfSqrt3}, {1.0f, -halfSqrt3}, {0.0f, halfSqrt3}};
-			vertexOrder = {0, 1, 2};
-			break;
+			return {{-1.0f, -halfSqrt3}, {1.0f, -halfSqrt3}, {0.0f, halfSqrt3}};
 
 		case PolygonType::SQUARE:
-			m_NumPoints = 4;
-			m_Points = {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
-			vertexOrder = {0, 1, 2, 0, 2, 3};
-			break;
+			return {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
 
 		case PolygonType::HEXAGON:
-			m_NumPoints = 6;
-			m_Points = {{1.0f, 0.0f},  {0.5f, halfSqrt3},	{-0.5f, halfSqrt3},
-						{-1.0f, 0.0f}, {-0.5f, -halfSqrt3}, {0.5f, -halfSqrt3}};
-			vertexOrder = {0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 4, 5};
-			break;
+			return {{1.0f, 0.0f},	{0.5f, halfSqrt3},	 {-0.5f, halfSqrt3},
+					{-1.0f, 0.0f}, {-0.5f, -halfSqrt3}, {0.5f, -halfSqrt3}};
 
 		default:
 			NT_ASSERT(false, "Unrecognized Polygon type!");
-			break;
+			return {};
 		}
+	}
 
-		VertexBufferLayout layout;
-		layout.push(VertexAttribType::FLOAT, 2, false); // position
+	const Nutella::Ref<const PolygonGeometry>& PolygonGeometry::Get(PolygonType type) {
+		NT_ASSERT(type < PolygonType::COUNT, "Unrecognized Polygon type!");
 
-		Ref<VertexBuffer> vbo;
-		vbo = VertexBuffer::Create(&m_Points[0], 2 * m_NumPoints * sizeof(float));
+		// built on first use; initialization of function statics is thread safe
+		static const Nutella::Ref<const PolygonGeometry> prototypes[] = {
+			Nutella::CreateRef<const PolygonGeometry>(RegularPoints(PolygonType::TRIANGLE)),
+			Nutella::CreateRef<const PolygonGeometry>(RegularPoints(PolygonType::SQUARE)),
+			Nutella::CreateRef<const PolygonGeometry>(RegularPoints(PolygonType::HEXAGON)),
+		};
+		static_assert(sizeof(prototypes) / sizeof(prototypes[0]) == (size_t) PolygonType::COUNT,
+					  "Every polygon type needs a prototype!");
 
-		Ref<IndexBuffer> ibo;
-		ibo = IndexBuffer::Create(&vertexOrder[0], 3 * (m_NumPoints - 2) * sizeof(uint32_t));
+		return prototypes[(uint32_t) type];
+	}
 
-		m_VAO = VertexArray::Create(layout, vbo, ibo);
+	/** Checks whether the path from o through a to b turns left by more than HULL_MIN_TURN */
+	static inline bool TurnsLeft(const glm::vec2& o, const glm::vec2& a, const glm::vec2& b) {
+		glm::vec2 in = a - o;
+		glm::vec2 out = b - a;
+		float cross = Cross(in, out);
 
-		m_TransformedPoints.resize(m_NumPoints);
+		// compare squares to avoid normalizing the edges
+		return cross > 0.0f && cross * cross > HULL_MIN_TURN * HULL_MIN_TURN *
+												   glm::dot(in, in) * glm::dot(out, out);
+	}
+
+	Nutella::Ref<const PolygonGeometry> PolygonGeometry::ConvexHull(
+		const std::vector<glm::vec2>& cloud, glm::vec2* centroid /* = nullptr */) {
+		NT_PROFILE_FUNC();
+		NT_ASSERT(cloud.size() >= 3, "Convex hull needs at least three points!");
+
+		std::vector<glm::vec2> sorted = cloud;
+		std::sort(sorted.begin(), sorted.end(), [](const glm::vec2& a, const glm::vec2& b) {
+			return a.x < b.x || (a.x == b.x && a.y < b.y);
+		});
+
+		// Andrew's monotone chain: sweep left to right to build the lower hull, then back to build
+		// the upper hull. Whenever the newest corner fails to turn left, it is inside the hull (or
+		// on its edge), and is dropped.
+		uint32_t numPoints = sorted.size();
+		std::vector<glm::vec2> hull(2 * numPoints);
+		uint32_t size = 0;
+
+		for (uint32_t i = 0; i < numPoints; i++) {
+			while (size >= 2 && !TurnsLeft(hull[size - 2], hull[size - 1], sorted[i]))
+				size--;
+			hull[size++] = sorted[i];
+		}
+
+		// the lower hull's corners are final, the upper hull starts from its last one
+		uint32_t lowerSize = size + 1;
+		for (uint32_t i = numPoints - 1; i-- > 0;) {
+			while (size >= lowerSize && !TurnsLeft(hull[size - 2], hull[size - 1], sorted[i]))
+				size--;
+			hull[size++] = sorted[i];
+		}
+
+		// the upper hull ends back at the first point
+		hull.resize(size - 1);
+		NT_ASSERT(hull.size() >= 3, "Convex hull needs three points that are not collinear!");
+
+		// centroid from a fan of triangles around the first corner, weighted by area
+		float area = 0.0f;
+		glm::vec2 center(0.0f);
+		for (uint32_t i = 1; i + 1 < hull.size(); i++) {
+			glm::vec2 a = hull[i] - hull[0];
+			glm::vec2 b = hull[i + 1] - hull[0];
+			float triangleArea = Cross(a, b) / 2.0f;
+
+			area += triangleArea;
+			center += triangleArea * (a + b) / 3.0f;
+		}
+		center = center / area + hull[0];
+
+		for (glm::vec2& point : hull)
+			point -= center;
+
+		if (centroid)
+			*centroid = center;
+
+		return Nutella::CreateRef<const PolygonGeometry>(hull);
 	}
 
+	Polygon::Polygon(const std::vector<glm::vec2>& points)
+		: Polygon(Nutella::CreateRef<const PolygonGeometry>(points)) {}
+
+	Polygon::Polygon(const Nutella::Ref<const PolygonGeometry>& geometry)
+		: m_Geometry(geometry), m_NumPoints(geometry->GetPoints().size()),
+		  m_Transform({glm::vec2(0.0f), 0.0f, glm::vec2(1.0f)}), m_Dirty(true), m_LastSupport(0) {
+		AllocateTransformedPoints();
+	}
+
+	Polygon::Polygon(PolygonType type) : Polygon(PolygonGeometry::Get(type)) {}
+
 	Polygon::~Polygon() {}
 
-	void Polygon::Render() { Renderer::Submit(m_VAO, m_Shader, m_TRSMat); }
+	void Polygon::AllocateTransformedPoints() {
+		uint32_t paddedSize =
+			(m_NumPoints + SUPPORT_SIMD_WIDTH - 1) / SUPPORT_SIMD_WIDTH * SUPPORT_SIMD_WIDTH;
+
+		m_TransformedPoints.resize(m_NumPoints);
+		m_TransformedX.resize(paddedSize);
+		m_TransformedY.resize(paddedSize);
+	}
 
 	glm::vec2 Polygon::Support(const glm::vec2& dir) const {
 		NT_PROFILE_FUNC();
 
-		glm::vec2 supportPoint = m_TransformedPoints[0];
-		float maxSupportDist = glm::dot(supportPoint, dir);
+		UpdateCache();
+
+		uint32_t index =
+			m_NumPoints >= HILL_CLIMB_MIN_POINTS ? SupportHillClimb(dir) : SupportLinear(dir);
+		return m_TransformedPoints[index];
+	}
+
+#ifdef FIZZ_SUPPORT_SSE
+	uint32_t Polygon::SupportLinear(const glm::vec2& dir) const {
+		__m128 dirX = _mm_set1_ps(dir.x);
+		__m128 dirY = _mm_set1_ps(dir.y);
+
+		// best distance and vertex index seen in each lane. Indices are kept as floats so they can
+		// be selected with the same masks as the distances (exact for any realistic vertex count).
+		__m128 maxDist = _mm_set1_ps(-FLT_MAX);
+		__m128 maxIndex = _mm_setzero_ps();
+		__m128 index = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+		const __m128 step = _mm_set1_ps((float) SUPPORT_SIMD_WIDTH);
+
+		for (uint32_t i = 0; i < m_TransformedX.size(); i += SUPPORT_SIMD_WIDTH) {
+			__m128 dist = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m_TransformedX[i]), dirX),
+									 _mm_mul_ps(_mm_loadu_ps(&m_TransformedY[i]), dirY));
+
+			// strictly greater, so each lane keeps the first of equally distant vertices
+			__m128 greater = _mm_cmpgt_ps(dist, maxDist);
+			maxDist = _mm_or_ps(_mm_and_ps(greater, dist), _mm_andnot_ps(greater, maxDist));
+			maxIndex = _mm_or_ps(_mm_and_ps(greater, index), _mm_andnot_ps(greater, maxIndex));
+			index = _mm_add_ps(index, step);
+		}
+
+		// reduce lanes without leaving registers: find the greatest distance, then the lowest
+		// index among the lanes holding it, to match the scalar path on ties
+		__m128 shuffled = _mm_max_ps(maxDist, _mm_shuffle_ps(maxDist, maxDist, 0b10110001));
+		__m128 best = _mm_max_ps(shuffled, _mm_shuffle_ps(shuffled, shuffled, 0b01001110));
+
+		__m128 isBest = _mm_cmpeq_ps(maxDist, best);
+		__m128 candidates = _mm_or_ps(_mm_and_ps(isBest, maxIndex),
+									  _mm_andnot_ps(isBest, _mm_set1_ps(FLT_MAX)));
+		shuffled = _mm_min_ps(candidates, _mm_shuffle_ps(candidates, candidates, 0b10110001));
+		__m128 bestIndex = _mm_min_ps(shuffled, _mm_shuffle_ps(shuffled, shuffled, 0b01001110));
 
-		for (int i = 1; i < m_NumPoints; i++) {
-			float currSupportDist = glm::dot(m_TransformedPoints[i], dir);
+		return (uint32_t) _mm_cvtss_si32(bestIndex);
+	}
+#else
+	uint32_t Polygon::SupportLinear(const glm::vec2& dir) const {
+		uint32_t supportIndex = 0;
+		float maxSupportDist = m_TransformedX[0] * dir.x + m_TransformedY[0] * dir.y;
+
+		for (uint32_t i = 1; i < m_NumPoints; i++) {
+			float currSupportDist = m_TransformedX[i] * dir.x + m_TransformedY[i] * dir.y;
 			if (currSupportDist > maxSupportDist) {
 				maxSupportDist = currSupportDist;
-				supportPoint = m_TransformedPoints[i];
+				supportIndex = i;
 			}
 		}
 
-		return supportPoint;
+		return supportIndex;
 	}
-
-	AABB Polygon::GetAABB() const {
-		glm::vec2 min(FLT_MAX), max(-FLT_MAX);
-
-		for (glm::vec2 point : m_TransformedPoints) {
-			min.x = glm::min(min.x, point.x);
-			min.y = glm::min(min.y, point.y);
-			max.x = glm::max(max.x, point.x);
-			max.y = glm::max(max.y, point.y);
+#endif
+
+	uint32_t Polygon::SupportHillClimb(const glm::vec2& dir) const {
+		uint32_t current = m_LastSupport.load(std::memory_order_relaxed);
+		if (current >= m_NumPoints)
+			current = 0;
+
+		float currentDist = glm::dot(m_TransformedPoints[current], dir);
+
+		// distance along dir is unimodal around a convex polygon, so walk towards whichever
+		// neighbour is further along until neither is
+		uint32_t next = current + 1 == m_NumPoints ? 0 : current + 1;
+		uint32_t prev = current == 0 ? m_NumPoints - 1 : current - 1;
+		float nextDist = glm::dot(m_TransformedPoints[next], dir);
+		float prevDist = glm::dot(m_TransformedPoints[prev], dir);
+
+		// a flat run of collinear vertices perpendicular to dir gives no direction to climb in
+		if (nextDist == currentDist && prevDist == currentDist)
+			return SupportLinear(dir);
+
+		if (nextDist > currentDist) {
+			do {
+				current = next;
+				currentDist = nextDist;
+				next = current + 1 == m_NumPoints ? 0 : current + 1;
+				nextDist = glm::dot(m_TransformedPoints[next], dir);
+			} while (nextDist > currentDist);
+		} else if (prevDist > currentDist) {
+			do {
+				current = prev;
+				currentDist = prevDist;
+				prev = current == 0 ? m_NumPoints - 1 : current - 1;
+				prevDist = glm::dot(m_TransformedPoints[prev], dir);
+			} while (prevDist > currentDist);
 		}
 
-		return AABB(min, max);
+		m_LastSupport.store(current, std::memory_order_relaxed);
+		return current;
+	}
+
+	AABB Polygon::GetAABB() const {
+		UpdateCache();
+		return m_AABB;
 	}
 
 	void Polygon::SetTransform(const Transform& transform) {
 		if (m_Transform != transform) {
 			m_Transform = transform;
+			m_Dirty = true;
+		}
+	}
 
-			// Update TRS matrix
-			m_TRSMat = glm::translate(glm::mat4(1.0f),
-									  {m_Transform.position.x, m_Transform.position.y, 0.0f});
-			m_TRSMat = glm::rotate(m_TRSMat, m_Transform.rotation, {0.0f, 0.0f, 1.0f});
-			m_TRSMat = glm::scale(m_TRSMat, {m_Transform.scale.x, m_Transform.scale.y, 1.0f});
+	void Polygon::UpdateCache() const {
+		if (m_Dirty)
+			TransformPoints();
+	}
 
-			// Update transformed points list
-			for (uint32_t i = 0; i < m_NumPoints; i++) {
-				m_TransformedPoints[i] =
-					m_TRSMat * glm::vec4(m_Points[i].x, m_Points[i].y, 0.0f, 1.0f);
-			}
+	void Polygon::TransformPoints() const {
+		NT_PROFILE_FUNC();
+
+		// scale, then rotate, then translate
+		float cos = glm::cos(m_Transform.rotation);
+		float sin = glm::sin(m_Transform.rotation);
+		glm::vec2 min(FLT_MAX), max(-FLT_MAX);
+
+		const std::vector<glm::vec2>& points = m_Geometry->GetPoints();
+		for (uint32_t i = 0; i < m_NumPoints; i++) {
+			glm::vec2 scaled = points[i] * m_Transform.scale;
+			glm::vec2 point = glm::vec2(cos * scaled.x - sin * scaled.y,
+										sin * scaled.x + cos * scaled.y) +
+							  m_Transform.position;
+
+			m_TransformedPoints[i] = point;
+			m_TransformedX[i] = point.x;
+			m_TransformedY[i] = point.y;
+			min = glm::min(min, point);
+			max = glm::max(max, point);
+		}
+
+		// padding repeats the first vertex, so it can never beat it as a support point
+		for (uint32_t i = m_NumPoints; i < m_TransformedX.size(); i++) {
+			m_TransformedX[i] = m_TransformedX[0];
+			m_TransformedY[i] = m_TransformedY[0];
 		}
+
+		m_AABB = AABB(min, max);
+		m_Dirty = false;
 	}
 
 	MassInfo Polygon::GetMassInfo(const float density) {
-		// HACK: currently, all polygons are treated like rectangles for mass purposes
-		AABB bounds = this->GetAABB();
-
-		float width = bounds.max.x - bounds.min.x;
-		float height = bounds.max.y - bounds.min.y;
+		// split the polygon into triangles fanning out from the origin, which is where bodies
+		// turn, and sum the area and second moment of area of each
+		const std::vector<glm::vec2>& points = m_Geometry->GetPoints();
+		float area = 0.0f;
+		float secondMoment = 0.0f;
+
+		for (uint32_t i = 0; i < m_NumPoints; i++) {
+			glm::vec2 a = points[i] * m_Transform.scale;
+			glm::vec2 b = points[i + 1 == m_NumPoints ? 0 : i + 1] * m_Transform.scale;
+			float cross = Cross(a, b);
+
+			area += cross / 2.0f;
+			secondMoment += cross * (glm::dot(a, a) + glm::dot(a, b) + glm::dot(b, b)) / 12.0f;
+		}
 
-		float mass = width * height * density;
+		// a mirroring scale flips the winding, and so the sign of both sums
+		float mass = glm::abs(area) * density;
 		float invMass = 1.0f / mass;
-		float rotInertia =
-			(width * width * width * height + height * height * height * width) * density / 3.0f;
+		float rotInertia = glm::abs(secondMoment) * density;
 		float invRotInertia = 1.0f / rotInertia;
 
 		return {density, mass, invMass, rotInertia, invRotInertia};
@@ -1,16 +1,62 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <Nutella.hpp>
+#include <atomic>
+#include <cstdint>
 #include <vector>
 
-#include <Nutella/Renderer/VertexArray.hpp>
-#include <Nutella/Renderer/Shader.hpp>
-
 #include "Shape.hpp"
 
 namespace Fizz {
 	enum class PolygonType { TRIANGLE = 0, SQUARE, HEXAGON, COUNT };
 
+	/** The local (untransformed) vertices of a polygon. Geometry never changes once it is
+	 *  created, so one copy can be shared by every polygon of the same shape, with each polygon
+	 *  only owning its transform and the vertices that transform produces.
+	 */
+	class PolygonGeometry {
+	  public:
+		/** Creates geometry from a list of 2D points. Points must form a convex polygon, and be
+		 *  given in counter-clockwise winding order. Use ConvexHull for points that may not.
+		 *
+		 *  @param points: A list of the polygon's vertices
+		 */
+		PolygonGeometry(const std::vector<glm::vec2>& points);
+
+		/** Gets the vertices, in counter-clockwise winding order */
+		inline const std::vector<glm::vec2>& GetPoints() const { return m_Points; }
+
+		/** Gets the geometry shared by every regular polygon of the given type. The geometry is
+		 *  built the first time it is asked for.
+		 *
+		 *  @param type: The type of polygon
+		 *
+		 *  @return The shared geometry for the type
+		 */
+		static const Nutella::Ref<const PolygonGeometry>& Get(PolygonType type);
+
+		/** Builds the smallest convex polygon containing every point in a cloud. Only the corners
+		 *  of the hull are kept; duplicate points, points inside the hull, and points on (or very
+		 *  nearly on) its edges are dropped, so support queries on the result test as few
+		 *  vertices as possible.
+		 *
+		 *  Bodies turn about their position, so the hull is moved to put its centroid (center of
+		 *  mass) on the origin. The offset removed is returned through centroid, for callers that
+		 *  need to place the hull where the cloud was.
+		 *
+		 *  @param cloud: The points to wrap, in any order. At least three must not be collinear.
+		 *  @param centroid: Set to the centroid of the hull around the original points, if given
+		 *
+		 *  @return Geometry for the hull, in counter-clockwise winding order
+		 */
+		static Nutella::Ref<const PolygonGeometry> ConvexHull(const std::vector<glm::vec2>& cloud,
+															  glm::vec2* centroid = nullptr);
+
+	  private:
+		std::vector<glm::vec2> m_Points;
+	};
+
 	/** A shape defined as the region eclosed by a series of points (vertices) and straight lines
 	 *  between them (edges)
 	 */
@@ -23,32 +69,81 @@ namespace Fizz {
 		 */
 		Polygon(const std::vector<glm::vec2>& points);
 
-		/** Creates a regular polygon of the given type
+		/** Creates a polygon sharing existing geometry. Cheaper than copying the points when
+		 *  many polygons have the same shape.
+		 *
+		 *  @param geometry: The polygon's local vertices
+		 */
+		Polygon(const Nutella::Ref<const PolygonGeometry>& geometry);
+
+		/** Creates a regular polygon of the given type. Its geometry is shared with every other
+		 *  polygon of the type.
 		 *
 		 *  @param type: The type of polygon to create
 		 */
 		Polygon(PolygonType type);
 		~Polygon();
 
-		virtual void Render() override;
+		virtual ShapeType GetType() const override { return ShapeType::POLYGON; }
 
 		virtual glm::vec2 Support(const glm::vec2& dir) const override;
 		virtual AABB GetAABB() const override;
 
 		virtual void SetTransform(const Transform& transform) override;
+		virtual void UpdateCache() const override;
 
 		virtual MassInfo GetMassInfo(const float density) override;
 
+		/** Gets the untransformed vertices of this polygon, in counter-clockwise winding order */
+		inline const std::vector<glm::vec2>& GetPoints() const { return m_Geometry->GetPoints(); }
+		/** Gets the geometry this polygon was built from, which may be shared with others */
+		inline const Nutella::Ref<const PolygonGeometry>& GetGeometry() const {
+			return m_Geometry;
+		}
+
+		/** Gets the vertices of this polygon with its transform applied, in the same order as
+		 *  GetPoints
+		 */
+		inline const std::vector<glm::vec2>& GetTransformedPoints() const {
+			UpdateCache();
+			return m_TransformedPoints;
+		}
+
 	  private:
-		std::vector<glm::vec2> m_Points;
+		/** Finds the index of the vertex furthest along dir by checking every vertex */
+		uint32_t SupportLinear(const glm::vec2& dir) const;
+
+		/** Finds the index of the vertex furthest along dir by walking the edges from the last
+		 *  support vertex found. Relies on the polygon being convex.
+		 */
+		uint32_t SupportHillClimb(const glm::vec2& dir) const;
+
+		/** Sets up the transformed vertex arrays to hold this polygon's vertices */
+		void AllocateTransformedPoints();
+
+		/** Moves every vertex by the current transform, and finds the bounding box around them */
+		void TransformPoints() const;
+
+	  private:
+		Nutella::Ref<const PolygonGeometry> m_Geometry;
 		uint32_t m_NumPoints;
 
 		Transform m_Transform;
-		std::vector<glm::vec2> m_TransformedPoints;
-		glm::mat4 m_TRSMat;
 
-		Nutella::Ref<Nutella::VertexArray> m_VAO;
-		// TODO: this should be shared between instances
-		Nutella::Ref<Nutella::Shader> m_Shader;
+		// everything below is derived from the transform, and only rebuilt when it is next needed
+		// after the transform changes
+		mutable bool m_Dirty;
+		mutable std::vector<glm::vec2> m_TransformedPoints;
+		mutable AABB m_AABB;
+
+		// transformed vertices as separate coordinate arrays, so support queries can test several
+		// vertices at once. Padded with copies of the first vertex to a multiple of the SIMD width.
+		mutable std::vector<float> m_TransformedX;
+		mutable std::vector<float> m_TransformedY;
+
+		// index of the last support vertex, where hill climbing starts. Support queries may run
+		// on several threads at once; any index is a valid starting point, so relaxed access is
+		// enough.
+		mutable std::atomic<uint32_t> m_LastSupport;
 	};
 } // namespace Fizz
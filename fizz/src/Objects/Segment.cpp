@@ -0,0 +1,34 @@
+#include "Segment.hpp"
+
+namespace Fizz {
+	Segment::Segment(const glm::vec2& start, const glm::vec2& end)
+		: m_LocalStart(start), m_LocalEnd(end), m_Points {start, end} {}
+
+	Segment::~Segment() {}
+
+	glm::vec2 Segment::Support(const glm::vec2& dir) const {
+		return glm::dot(m_Points[1] - m_Points[0], dir) > 0.0f ? m_Points[1] : m_Points[0];
+	}
+
+	AABB Segment::GetAABB() const {
+		return {glm::min(m_Points[0], m_Points[1]), glm::max(m_Points[0], m_Points[1])};
+	}
+
+	void Segment::SetTransform(const Transform& transform) {
+		// scale, then rotate, then translate. Only two points, so there is nothing worth caching.
+		float cos = glm::cos(transform.rotation);
+		float sin = glm::sin(transform.rotation);
+
+		glm::vec2 start = m_LocalStart * transform.scale;
+		glm::vec2 end = m_LocalEnd * transform.scale;
+		m_Points[0] = glm::vec2(cos * start.x - sin * start.y, sin * start.x + cos * start.y) +
+					  transform.position;
+		m_Points[1] = glm::vec2(cos * end.x - sin * end.y, sin * end.x + cos * end.y) +
+					  transform.position;
+	}
+
+	MassInfo Segment::GetMassInfo(const float density) {
+		// no area -> static, whatever the density
+		return {density, 0.0f, 0.0f, 0.0f, 0.0f};
+	}
+} // namespace Fizz
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Shape.hpp"
+
+namespace Fizz {
+	/** A straight line between two points. Segments have no area, and so no mass; they are meant
+	 *  for static geometry like terrain, which only needs a surface for other shapes to rest on.
+	 */
+	class Segment : public Shape {
+	  public:
+		/** Creates a segment between two points. The points are scaled, rotated, and moved by the
+		 *  segment's transform, like the vertices of a polygon.
+		 *
+		 *  @param start: The first end of the segment
+		 *  @param end: The second end of the segment
+		 */
+		Segment(const glm::vec2& start, const glm::vec2& end);
+		~Segment();
+
+		virtual ShapeType GetType() const override { return ShapeType::SEGMENT; }
+
+		virtual glm::vec2 Support(const glm::vec2& dir) const override;
+		virtual AABB GetAABB() const override;
+
+		virtual void SetTransform(const Transform& transform) override;
+
+		virtual MassInfo GetMassInfo(const float density) override;
+
+		/** Gets the untransformed ends of this segment */
+		inline const glm::vec2& GetLocalStart() const { return m_LocalStart; }
+		inline const glm::vec2& GetLocalEnd() const { return m_LocalEnd; }
+
+		/** Gets the ends of this segment with its transform applied */
+		inline const glm::vec2& GetStart() const { return m_Points[0]; }
+		inline const glm::vec2& GetEnd() const { return m_Points[1]; }
+
+		/** Gets both transformed ends, start first, as an array */
+		inline const glm::vec2* GetPoints() const { return m_Points; }
+
+	  private:
+		glm::vec2 m_LocalStart, m_LocalEnd;
+		glm::vec2 m_Points[2];
+	};
+} // namespace Fizz
@@ -31,11 +31,18 @@ namespace Fizz {
 		float invRotIntertia;
 	};
 
+	/** The concrete kind of a shape. Used by systems outside the physics core (e.g. rendering) that
+	 *  need to treat each kind of shape differently.
+	 */
+	enum class ShapeType { CIRCLE = 0, POLYGON, CAPSULE, SEGMENT, COUNT };
+
 	/** Represents a contigious collection of points in 2D space */
 	class Shape {
 	  public:
-		/* Draws the shape on the screen */
-		virtual void Render() = 0;
+		virtual ~Shape() = default;
+
+		/** Gets the concrete kind of this shape */
+		virtual ShapeType GetType() const = 0;
 
 		/** Gets the farthest point in the given direction on the shape (i.e. the point with the
 		 *  largest dot product in that direction).
@@ -57,10 +64,21 @@ namespace Fizz {
 		 *  completely intrinsic, having data like a transform is useful for things like testing
 		 *  collision with other shapes.
 		 *
+		 *  Shapes may put off work that depends on the transform (e.g. moving their vertices)
+		 *  until they are next queried, so setting the transform several times in a row only
+		 *  costs as much as setting it once.
+		 *
 		 *  @param transform: The new posision, rotation, and scale of this shape
 		 */
 		virtual void SetTransform(const Transform& transform) = 0;
 
+		/** Does any work put off since the transform was last set. Queries do this themselves, so
+		 *  this never has to be called, but a query that does the work changes the shape, and
+		 *  must not run at the same time as any other query on it. Calling this first makes it
+		 *  safe to query the shape from several threads at once.
+		 */
+		virtual void UpdateCache() const {}
+
 		/** Gets information about how responsive the object represented by the shape should be to
 		 *  forces. This should be determined by the density of the object, the size of the shape,
 		 *  and inherent properties about the shape (for rotational inertial purposes).
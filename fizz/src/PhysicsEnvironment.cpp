@@ -1,63 +1,334 @@
 #include "PhysicsEnvironment.hpp"
 
-#include "Collisions/CollisionResolution.hpp"
-#include "Collisions/Quadtree.hpp"
+#include <algorithm>
+#include <cmath>
+
+#include "Collisions/CollisionDispatch.hpp"
+#include "Collisions/TimeOfImpact.hpp"
 
 using namespace Nutella;
 using namespace Fizz;
 
 namespace Fizz {
+	// number of bodies handed to a thread at once when integrating
+	static const uint32_t INTEGRATION_GRAIN_SIZE = 256;
+	// number of possible collisions handed to a thread at once during the narrow phase
+	static const uint32_t NARROW_PHASE_GRAIN_SIZE = 64;
+	// how far a bullet is pushed into whatever it hits, so the next step finds the contact. Must
+	// be less than the contact solver's slop, or the bullet is shoved back out.
+	static const float BULLET_OVERLAP = 0.005f;
+
+	PhysicsEnvironment::PhysicsEnvironment(BroadPhaseType broadPhase, uint32_t numThreads)
+		: PhysicsEnvironment(broadPhase, CreateRef<JobSystem>(numThreads)) {}
+
+	PhysicsEnvironment::PhysicsEnvironment(BroadPhaseType broadPhase,
+										   const Ref<JobSystem>& jobSystem)
+		: m_BroadPhase(BroadPhase::Create(broadPhase)), m_FixedStep(0.0f), m_MaxSteps(8),
+		  m_Substeps(1), m_Accumulator(0.0f), m_InterpolationAlpha(1.0f), m_Gravity(0.0f),
+		  m_SleepEnabled(true), m_JobSystem(jobSystem) {}
+
 	void PhysicsEnvironment::Update(Nutella::Timestep ts) {
 		NT_PROFILE_FUNC();
 
-		UpdateObjects(ts);
-		FindCollisions();
-		ResolveCollisions();
-	}
+		if (m_FixedStep == 0.0f) {
+			Step(ts);
+			m_InterpolationAlpha = 1.0f;
+			return;
+		}
+
+		m_Accumulator += ts;
+		for (uint32_t steps = 0; steps < m_MaxSteps && m_Accumulator >= m_FixedStep; steps++) {
+			Step(m_FixedStep);
+			m_Accumulator -= m_FixedStep;
+		}
 
-	void PhysicsEnvironment::Render() {
-		for (Ref<PhysicsObject>& object : m_Objects)
-			object->Render();
+		// a hitch longer than the cap is dropped rather than carried over, otherwise every
+		// update after it would also take the maximum number of steps
+		if (m_Accumulator >= m_FixedStep)
+			m_Accumulator = std::fmod(m_Accumulator, m_FixedStep);
+
+		m_InterpolationAlpha = m_Accumulator / m_FixedStep;
 	}
 
-	void PhysicsEnvironment::UpdateObjects(Nutella::Timestep ts) {
-		for (Ref<PhysicsObject>& object : m_Objects)
-			object->Update(ts);
+	void PhysicsEnvironment::SetFixedTimestep(float step, uint32_t maxSteps) {
+		NT_ASSERT(step >= 0.0f, "Fixed timestep cannot be negative!");
+		NT_ASSERT(maxSteps > 0, "Updates must be allowed at least one step!");
+
+		m_FixedStep = step;
+		m_MaxSteps = maxSteps;
+		m_Accumulator = 0.0f;
+		m_InterpolationAlpha = 1.0f;
 	}
 
-	void PhysicsEnvironment::FindCollisions() {
+	void PhysicsEnvironment::Step(float dt) {
 		NT_PROFILE_FUNC();
 
-		// broad phase
-		CollisionList possibleCollisions;
-		{
-			NT_PROFILE_SCOPE("Broad Phase Collision Detection");
-			// TODO: figure out better way to do these borders
-			Quadtree qt(0, AABB(glm::vec2(-8.0f), glm::vec2(8.0f)));
-			for (Ref<PhysicsObject> object : m_Objects)
-				qt.Insert(object);
-
-			possibleCollisions = qt.GetPossibleCollisions();
+		// objects are drawn blended from where they were before the whole step
+		m_Bodies.SaveTransforms();
+
+		Nutella::Timestep ts = dt / m_Substeps;
+		for (uint32_t i = 0; i < m_Substeps; i++) {
+			// finding collisions only reads positions, so it overlaps with applying forces
+			JobHandle velocitiesUpdated = UpdateVelocities(ts);
+			JobHandle collisionsFound = FindCollisions();
+			JobHandle collisionsResolved =
+				ResolveCollisions(velocitiesUpdated, collisionsFound, ts);
+			JobHandle positionsUpdated = UpdatePositions(collisionsResolved, ts);
+			JobHandle bulletsSwept = SweepBullets(positionsUpdated);
+
+			m_JobSystem->Wait(bulletsSwept);
 		}
+	}
+
+	Ref<PhysicsObject> PhysicsEnvironment::Create(Ref<Shape> shape, Transform transform,
+												  float density) {
+		BodyID id = m_Bodies.Create(shape, transform, density);
+		Ref<PhysicsObject> object = CreateRef<PhysicsObject>(m_Bodies, id);
+		m_Objects.push_back(object);
 
-		// narrow phase
-		m_Collisions.clear();
+		return object;
+	}
+
+	void PhysicsEnvironment::Remove(const Ref<PhysicsObject>& object) {
+		BodyID id = object->GetID();
+
+		// wake the body's partners, and forget its pairs: its ID is freed below, so a later Remove
+		// or Create before the next update would otherwise find a stale or reused ID in them
+		auto removePair = [this, id](BodyID A, BodyID B) {
+			if (A != id && B != id)
+				return false;
+
+			m_Bodies.Wake(m_Bodies.GetIndex(A == id ? B : A));
+			return true;
+		};
 
-		for (auto& [A, B] : possibleCollisions) {
-			Collision collision = GJKGetCollision(A, B);
+		uint32_t numKept = 0;
+		for (uint32_t i = 0; i < m_Collisions.size(); i++) {
+			if (removePair(m_Collisions[i].collider, m_Collisions[i].collided))
+				continue;
 
-			if (collision.exists) {
-				m_Collisions.push_back(collision);
-			}
+			m_Collisions[numKept] = m_Collisions[i];
+			m_CollisionStates[numKept] = m_CollisionStates[i];
+			numKept++;
 		}
+		m_Collisions.resize(numKept);
+		m_CollisionStates.resize(numKept);
+
+		m_RestingPairs.erase(std::remove_if(m_RestingPairs.begin(), m_RestingPairs.end(),
+											[&](const std::pair<BodyID, BodyID>& pair) {
+												return removePair(pair.first, pair.second);
+											}),
+							 m_RestingPairs.end());
+
+		// body store fills the hole with its last body, handles must follow the same order
+		uint32_t index = m_Bodies.GetIndex(object->GetID());
+		m_BroadPhase->Remove(object->GetID());
+		m_PairCache.Remove(object->GetID());
+		m_Bodies.Destroy(object->GetID());
+
+		m_Objects[index] = m_Objects.back();
+		m_Objects.pop_back();
 	}
 
-	void PhysicsEnvironment::ResolveCollisions() {
-		NT_PROFILE_FUNC();
+	void PhysicsEnvironment::SetBroadPhase(BroadPhaseType type) {
+		if (type != m_BroadPhase->GetType())
+			m_BroadPhase = BroadPhase::Create(type);
+	}
+
+	void PhysicsEnvironment::SetSleepEnabled(bool enabled) {
+		m_SleepEnabled = enabled;
 
-		for (Collision collision : m_Collisions) {
-			ResolveCollision(collision);
-			SinkingCorrection(collision);
+		if (!enabled) {
+			for (uint32_t i = 0; i < m_Bodies.Size(); i++)
+				m_Bodies.Wake(i);
 		}
 	}
+
+	JobHandle PhysicsEnvironment::UpdateVelocities(Nutella::Timestep ts) {
+		float dt = ts;
+		return m_JobSystem->ParallelFor(
+			m_Bodies.Size(), INTEGRATION_GRAIN_SIZE, [this, dt](uint32_t begin, uint32_t end) {
+				m_Bodies.IntegrateVelocities(dt, m_Gravity, begin, end);
+			});
+	}
+
+	JobHandle PhysicsEnvironment::FindCollisions() {
+		// broad phase
+		JobHandle broadPhase = m_JobSystem->Schedule(
+			[this]() {
+				NT_PROFILE_SCOPE("Broad Phase Collision Detection");
+				// every broad phase reads the bounds of every shape, which also brings shapes
+				// moved by hand since the last update up to date before the narrow phase reads
+				// them from several threads
+				m_BroadPhase->FindPossibleCollisions(m_Bodies, m_PossibleCollisions);
+
+				// broad phases may report a pair either way round, cached state needs one order
+				for (auto& [A, B] : m_PossibleCollisions) {
+					if (A > B)
+						std::swap(A, B);
+				}
+
+				m_PairCache.Update(m_PossibleCollisions, m_PairStates);
+				m_NarrowPhaseResults.resize(m_PossibleCollisions.size());
+			});
+
+		// neither body of a resting pair moves, so whatever contact it had still holds
+		auto resting = [this](BodyID A, BodyID B) {
+			return !m_Bodies.IsAwake(m_Bodies.GetIndex(A)) &&
+				   !m_Bodies.IsAwake(m_Bodies.GetIndex(B));
+		};
+
+		// narrow phase; pairs are independent, so they are checked in parallel. Each pair writes to
+		// its own slot, so the collisions found are in the same order no matter how many threads
+		// are used.
+		JobHandle narrowPhase = m_JobSystem->ParallelFor(
+			[this]() { return (uint32_t) m_PossibleCollisions.size(); }, NARROW_PHASE_GRAIN_SIZE,
+			[this, resting](uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; i++) {
+					auto [A, B] = m_PossibleCollisions[i];
+					if (resting(A, B))
+						continue;
+
+					m_NarrowPhaseResults[i] = GetCollision(m_Bodies, A, B, m_PairStates[i]->gjk);
+				}
+			},
+			{broadPhase});
+
+		return m_JobSystem->Schedule(
+			[this, resting]() {
+				m_Collisions.clear();
+				m_CollisionStates.clear();
+				m_RestingPairs.clear();
+
+				for (uint32_t i = 0; i < m_NarrowPhaseResults.size(); i++) {
+					auto [A, B] = m_PossibleCollisions[i];
+					if (resting(A, B)) {
+						// resting pairs keep their contacts, ready for when they wake
+						if (m_PairStates[i]->numImpulses > 0)
+							m_RestingPairs.push_back({A, B});
+					} else if (m_NarrowPhaseResults[i].exists) {
+						m_Collisions.push_back(m_NarrowPhaseResults[i]);
+						m_CollisionStates.push_back(m_PairStates[i]);
+					} else {
+						// pairs that come apart lose their contacts
+						m_PairStates[i]->numImpulses = 0;
+					}
+				}
+			},
+			{narrowPhase});
+	}
+
+	JobHandle PhysicsEnvironment::ResolveCollisions(const JobHandle& velocitiesUpdated,
+												   const JobHandle& collisionsFound,
+												   Nutella::Timestep ts) {
+		// collisions sharing a body affect each other, so the solver splits them into batches
+		// that share no bodies itself, and solves each batch in parallel
+		float dt = ts;
+		return m_JobSystem->Schedule(
+			[this, dt]() {
+				NT_PROFILE_SCOPE("Collision Resolution");
+
+				// sleeping bodies hit by awake ones wake up along with everything touching them
+				m_Islands.Build(m_Bodies, m_Collisions, m_RestingPairs);
+				m_Islands.Wake(m_Bodies);
+
+				m_Solver.Solve(m_Bodies, m_Collisions, m_CollisionStates, dt, *m_JobSystem);
+
+				if (m_SleepEnabled)
+					m_Islands.Sleep(m_Bodies);
+			},
+			{velocitiesUpdated, collisionsFound});
+	}
+
+	JobHandle PhysicsEnvironment::UpdatePositions(const JobHandle& collisionsResolved,
+												 Nutella::Timestep ts) {
+		float dt = ts;
+		return m_JobSystem->ParallelFor(
+			m_Bodies.Size(), INTEGRATION_GRAIN_SIZE,
+			[this, dt](uint32_t begin, uint32_t end) {
+				m_Bodies.IntegratePositions(dt, begin, end);
+				m_Bodies.UpdateShapes(begin, end);
+			},
+			{collisionsResolved});
+	}
+
+	JobHandle PhysicsEnvironment::SweepBullets(const JobHandle& positionsUpdated) {
+		// bullets are swept one at a time, since each sweep moves its bullet's shape around
+		return m_JobSystem->Schedule(
+			[this]() {
+				NT_PROFILE_SCOPE("Continuous Collision Detection");
+
+				// the broad phase saw every body before it moved this step, so sweeps look as far
+				// past their path as any other body has moved since. Bullets move too far for
+				// that, and are swept against each other directly.
+				m_Bullets.clear();
+				float maxTravel = 0.0f;
+				for (uint32_t i = 0; i < m_Bodies.Size(); i++) {
+					if (!m_Bodies.IsAwake(i))
+						continue;
+
+					if (m_Bodies.IsBullet(i)) {
+						m_Bullets.push_back(i);
+					} else {
+						glm::vec2 saved = m_Bodies.GetSavedTransform(i).position;
+						maxTravel = glm::max(maxTravel,
+											 glm::length(m_Bodies.GetPosition(i) - saved));
+					}
+				}
+
+				for (uint32_t bullet : m_Bullets)
+					SweepBullet(bullet, maxTravel);
+			},
+			{positionsUpdated});
+	}
+
+	void PhysicsEnvironment::SweepBullet(uint32_t index, float margin) {
+		// swept from where the bullet was before the step, which also covers the substeps so far
+		Shape& shape = *m_Bodies.GetShape(index);
+		Transform start = m_Bodies.GetSavedTransform(index);
+		Transform end = m_Bodies.GetTransform(index);
+
+		// the bullet stays inside a circle around its position however it is turned, so
+		// nothing outside the circle's path can be hit
+		AABB bounds = shape.GetAABB();
+		float radius = glm::length((bounds.min + bounds.max) / 2.0f - end.position) +
+					   glm::length((bounds.max - bounds.min) / 2.0f);
+		AABB swept = AABB::Union(AABB(start.position - radius, start.position + radius),
+								 AABB(end.position - radius, end.position + radius));
+
+		TimeOfImpact first = {TOIState::MISSED, 1.0f, glm::vec2(0.0f), 0.0f};
+		auto sweep = [&](uint32_t target) {
+			const Shape& targetShape = *m_Bodies.GetShape(target);
+			if (target == index || !swept.Intersects(targetShape.GetAABB()))
+				return;
+
+			TimeOfImpact toi = GetTimeOfImpact(shape, start, end, radius, targetShape);
+			bool reached = toi.state == TOIState::HIT || toi.state == TOIState::STALLED;
+			if (reached && toi.t < first.t)
+				first = toi;
+		};
+
+		m_BroadPhase->Query(swept.Expand(margin), m_SweepCandidates);
+		for (BodyID id : m_SweepCandidates) {
+			uint32_t target = m_Bodies.GetIndex(id);
+			if (!m_Bodies.IsBullet(target) || !m_Bodies.IsAwake(target))
+				sweep(target);
+		}
+		for (uint32_t bullet : m_Bullets)
+			sweep(bullet);
+
+		if (first.state == TOIState::MISSED) {
+			// sweeps leave the shape wherever they stopped
+			shape.SetTransform(end);
+			return;
+		}
+
+		// stop just inside what was hit; the next step finds the contact, and the solver deals
+		// with the impact like any other. A stalled sweep may still be far from the target, so it
+		// only stops where it is known to be safe, and carries on from there next step.
+		glm::vec2 position = glm::mix(start.position, end.position, first.t);
+		if (first.state == TOIState::HIT)
+			position += (first.separation + BULLET_OVERLAP) * first.normal;
+		m_Bodies.Place(index, position, glm::mix(start.rotation, end.rotation, first.t));
+	}
 } // namespace Fizz
@@ -2,27 +2,114 @@
 
 #include "Objects/PhysicsObject.hpp"
 #include "Collisions/CollisionDetection.hpp"
+#include "Collisions/BroadPhase.hpp"
+#include "Collisions/PairCache.hpp"
+#include "Collisions/ContactSolver.hpp"
+#include "Collisions/Islands.hpp"
+#include "Threading/JobSystem.hpp"
 
 namespace Fizz {
 	/* Groups multiple physics objects together and manages each of them. Provides a centralized way
-	   to update, render, and resolve collisions between all physics objects in the environment.
+	   to update and resolve collisions between all physics objects in the environment. The
+	   environment does not depend on a graphics context; see PhysicsRenderer for drawing it.
 	 */
 	class PhysicsEnvironment {
 	  public:
-		/* Updates each physics object in the environment.
+		/* Creates an empty environment.
 
-		   @param ts: The timestep to use when updating
+		   @param broadPhase: The strategy to use for broad phase collision detection
+		   @param numThreads: The number of threads to simulate on, including the thread calling
+		   Update. 0 uses one thread per hardware core.
+		 */
+		PhysicsEnvironment(BroadPhaseType broadPhase = BroadPhaseType::DYNAMIC_TREE,
+						   uint32_t numThreads = 0);
+
+		/* Creates an empty environment that runs on an existing job system, e.g. one shared by
+		   several environments.
+
+		   @param broadPhase: The strategy to use for broad phase collision detection
+		   @param jobSystem: The job system to simulate on
+		 */
+		PhysicsEnvironment(BroadPhaseType broadPhase, const Nutella::Ref<JobSystem>& jobSystem);
+
+		// the jobs of each step capture the environment, and objects point into its body store, so
+		// it cannot be copied or moved
+		PhysicsEnvironment(const PhysicsEnvironment&) = delete;
+		PhysicsEnvironment(PhysicsEnvironment&&) = delete;
+		PhysicsEnvironment& operator=(const PhysicsEnvironment&) = delete;
+		PhysicsEnvironment& operator=(PhysicsEnvironment&&) = delete;
+
+		/* Updates each physics object in the environment. Each step is run as a graph of jobs
+		   on the environment's job system, and the update returns once every stage has finished.
+
+		   Collisions are found between the objects where they were at the start of a step, and
+		   resolved before the objects are moved. Sleeping objects are not moved, and pairs of
+		   them are not checked for collisions. Bullets are then swept along the move they just
+		   made, and pulled back to wherever they first hit something (see
+		   PhysicsObject::SetBullet).
+
+		   By default the whole timestep is simulated as one step. With a fixed timestep set, the
+		   timestep is instead added to an accumulator, and as many fixed steps are taken as fit
+		   in it; see SetFixedTimestep.
+
+		   @param ts: The time that has passed since the last update
 		 */
 		void Update(Nutella::Timestep ts);
 
-		/* Renders each physics object in the environment */
-		void Render();
+		/* Makes Update advance the simulation in steps of a fixed size, no matter how long each
+		   frame is. Every step then costs about the same, and the result does not depend on the
+		   frame rate. Time that does not fill a whole step is carried over to the next update.
+
+		   @param step: The length of each step in seconds, or 0 to simulate each update as one
+		   step of whatever length it is given
+		   @param maxSteps: The most steps taken in one update. Time left over beyond that is
+		   dropped, so a long frame slows the simulation down instead of making the next update
+		   longer still.
+		 */
+		void SetFixedTimestep(float step, uint32_t maxSteps = 8);
+		inline float GetFixedTimestep() const { return m_FixedStep; }
+		inline uint32_t GetMaxSteps() const { return m_MaxSteps; }
+
+		/* Sets the number of substeps each step is split into. Every substep runs the whole
+		   pipeline (collision detection, solving, and integration) over an equal share of the
+		   step, which trades speed for stiffer, more accurate contacts.
+
+		   @param substeps: The number of substeps per step. Must be at least 1.
+		 */
+		inline void SetSubsteps(uint32_t substeps) {
+			NT_ASSERT(substeps > 0, "Steps must have at least one substep!");
+			m_Substeps = substeps;
+		}
+		inline uint32_t GetSubsteps() const { return m_Substeps; }
+
+		/* Gets how far the time accumulated by a fixed timestep has run past the last step, as a
+		   fraction of a step. Drawing objects blended this far between their last two steps (see
+		   PhysicsObject::GetInterpolatedTransform) keeps motion smooth when steps do not line up
+		   with frames. Always 1 when no fixed timestep is set.
+
+		   @return The interpolation factor, in [0, 1]
+		 */
+		inline float GetInterpolationAlpha() const { return m_InterpolationAlpha; }
+
+		/* Creates a new physics object in the environment.
+
+		   @param shape: The shape of the object
+		   @param transform: The initial position, rotation, and scale of the object
+		   @param density: The density of the object, used to calculate its mass
+
+		   @return A handle to the new physics object
+		*/
+		Nutella::Ref<Fizz::PhysicsObject>
+		Create(Nutella::Ref<Shape> shape,
+			   Transform transform = {glm::vec2(0.0f, 0.0f), 0.0f, glm::vec2(0.2f, 0.2f)},
+			   float density = 1.0f);
 
-		/* Adds a physics object to the environment.
+		/* Removes a physics object from the environment. The object must not be used afterwards.
+		   Anything touching the object is woken, so nothing is left resting on thin air.
 
-		   @param object: The physics object to add
+		   @param object: The physics object to remove
 		*/
-		inline void Add(Nutella::Ref<Fizz::PhysicsObject> object) { m_Objects.push_back(object); }
+		void Remove(const Nutella::Ref<Fizz::PhysicsObject>& object);
 
 		/* Gets a list of objects in the environment
 
@@ -37,13 +124,100 @@ namespace Fizz {
 		 */
 		inline std::vector<Fizz::Collision>& GetCollisions() { return m_Collisions; };
 
+		/* Changes the strategy used for broad phase collision detection. Any state kept by the old
+		   broad phase is discarded.
+
+		   @param type: The new broad phase strategy
+		 */
+		void SetBroadPhase(BroadPhaseType type);
+		inline BroadPhaseType GetBroadPhase() const { return m_BroadPhase->GetType(); }
+
+		/* Sets the number of times the contact solver sweeps over every contact per update. More
+		   iterations let impulses travel further through stacks of bodies, at a higher cost.
+
+		   @param velocityIterations: The number of sweeps solving contact velocities
+		   @param positionIterations: The number of sweeps correcting penetration
+		 */
+		inline void SetSolverIterations(uint32_t velocityIterations,
+										uint32_t positionIterations) {
+			m_Solver.SetVelocityIterations(velocityIterations);
+			m_Solver.SetPositionIterations(positionIterations);
+		}
+		inline uint32_t GetVelocityIterations() const { return m_Solver.GetVelocityIterations(); }
+		inline uint32_t GetPositionIterations() const { return m_Solver.GetPositionIterations(); }
+
+		/* Sets the acceleration applied to every object with finite mass. Unlike a force applied
+		   to each object, gravity does not wake sleeping objects, so objects resting under
+		   gravity can fall asleep.
+
+		   @param gravity: The acceleration due to gravity
+		 */
+		inline void SetGravity(const glm::vec2& gravity) { m_Gravity = gravity; }
+		inline const glm::vec2& GetGravity() const { return m_Gravity; }
+
+		/* Sets whether objects that come to rest are put to sleep. Disabling sleep wakes every
+		   object.
+
+		   @param enabled: Whether objects may sleep
+		 */
+		void SetSleepEnabled(bool enabled);
+		inline bool IsSleepEnabled() const { return m_SleepEnabled; }
+
 	  private:
-		void UpdateObjects(Nutella::Timestep ts);
-		void FindCollisions();
-		void ResolveCollisions();
+		/* Advances the simulation by one step, split into substeps */
+		void Step(float dt);
+
+		// each stage schedules its jobs, and returns a job that finishes once the stage is done
+		JobHandle UpdateVelocities(Nutella::Timestep ts);
+		JobHandle FindCollisions();
+		JobHandle ResolveCollisions(const JobHandle& velocitiesUpdated,
+									const JobHandle& collisionsFound, Nutella::Timestep ts);
+		JobHandle UpdatePositions(const JobHandle& collisionsResolved, Nutella::Timestep ts);
+		JobHandle SweepBullets(const JobHandle& positionsUpdated);
+
+		/* Sweeps a bullet from where it was before the step to where it is now, against every
+		   other body near its path where that body is now, and moves the bullet back to the
+		   first hit. Bodies are found with the broad phase, by the bounds it saw before they
+		   moved, so the search is grown by the given margin.
+		 */
+		void SweepBullet(uint32_t index, float margin);
 
 	  private:
+		BodyStore m_Bodies;
+		// handles to each body, in the same order as the body store
 		std::vector<Nutella::Ref<Fizz::PhysicsObject>> m_Objects;
 		std::vector<Fizz::Collision> m_Collisions;
+		// cached state of each collision's pair, in the same order
+		std::vector<PairState*> m_CollisionStates;
+
+		Nutella::Ref<BroadPhase> m_BroadPhase;
+		CollisionList m_PossibleCollisions;
+		// indices of the awake bullets, and bodies near the path of the bullet being swept
+		std::vector<uint32_t> m_Bullets;
+		std::vector<BodyID> m_SweepCandidates;
+
+		// narrow phase state carried between updates, and the state of each possible collision
+		PairCache m_PairCache;
+		std::vector<PairState*> m_PairStates;
+
+		ContactSolver m_Solver;
+
+		// 0 when each update is simulated as a single step
+		float m_FixedStep;
+		uint32_t m_MaxSteps;
+		uint32_t m_Substeps;
+		// time passed that has not been simulated yet
+		float m_Accumulator;
+		float m_InterpolationAlpha;
+
+		glm::vec2 m_Gravity;
+		bool m_SleepEnabled;
+		Islands m_Islands;
+		// pairs of sleeping objects that were touching when they fell asleep
+		CollisionList m_RestingPairs;
+
+		Nutella::Ref<JobSystem> m_JobSystem;
+		// narrow phase result for each possible collision, in the same order
+		std::vector<Fizz::Collision> m_NarrowPhaseResults;
 	};
 } // namespace Fizz
@@ -0,0 +1,173 @@
+#include "PhysicsRenderer.hpp"
+
+#include <Nutella/Renderer/Renderer.hpp>
+
+namespace Fizz {
+	using namespace Nutella;
+
+	// segments have no area, so they are drawn as a strip this wide
+	static const float SEGMENT_WIDTH = 0.02f;
+
+	PhysicsRenderer::PhysicsRenderer()
+		: m_CircleShader(Shader::Create("fizz/res/shaders/Circle.shader")),
+		  m_MeshShader(Shader::Create("fizz/res/shaders/Mesh.shader")) {
+		// circles are drawn as a quad covering the bounding box of the circle, and each corner
+		// carries the circle, so the fragment shader can cut the circle out of the quad
+		m_CircleLayout.push(VertexAttribType::FLOAT, 2, false); // position
+		m_CircleLayout.push(VertexAttribType::FLOAT, 2, false); // center
+		m_CircleLayout.push(VertexAttribType::FLOAT, 1, false); // radius
+
+		m_MeshLayout.push(VertexAttribType::FLOAT, 2, false); // position
+	}
+
+	PhysicsRenderer::~PhysicsRenderer() {}
+
+	void PhysicsRenderer::Render(PhysicsEnvironment& env) {
+		NT_PROFILE_FUNC();
+
+		m_CircleVertices.clear();
+		m_CircleIndices.clear();
+		m_PolygonVertices.clear();
+		m_PolygonIndices.clear();
+
+		float alpha = env.GetInterpolationAlpha();
+		for (Ref<PhysicsObject>& object : env.GetObjects()) {
+			const Shape& shape = *object->GetShape();
+			Transform transform = object->GetInterpolatedTransform(alpha);
+
+			switch (shape.GetType()) {
+			case ShapeType::CIRCLE:
+				AddCircle(static_cast<const Circle&>(shape), transform);
+				break;
+
+			case ShapeType::POLYGON:
+				AddPolygon(static_cast<const Polygon&>(shape), transform);
+				break;
+
+			case ShapeType::CAPSULE:
+				AddCapsule(static_cast<const Capsule&>(shape), transform);
+				break;
+
+			case ShapeType::SEGMENT:
+				AddSegment(static_cast<const Segment&>(shape), transform);
+				break;
+
+			default:
+				NT_ASSERT(false, "Unrecognized Shape type!");
+				break;
+			}
+		}
+
+		// batch vertices are already in world space
+		Submit(m_CircleVertices, m_CircleIndices, m_CircleLayout, m_CircleShader, m_CircleBuffers);
+		Submit(m_PolygonVertices, m_PolygonIndices, m_MeshLayout, m_MeshShader,
+			   m_PolygonBuffers);
+	}
+
+	void PhysicsRenderer::AddCircle(const Circle& circle, const Transform& transform) {
+		AddDisc(transform.position, circle.GetRadius());
+	}
+
+	void PhysicsRenderer::AddDisc(const glm::vec2& center, float radius) {
+		uint32_t first = m_CircleVertices.size() / 5;
+		const glm::vec2 corners[] = {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
+		for (const glm::vec2& corner : corners) {
+			glm::vec2 position = center + radius * corner;
+			m_CircleVertices.insert(m_CircleVertices.end(),
+									{position.x, position.y, center.x, center.y, radius});
+		}
+
+		m_CircleIndices.insert(m_CircleIndices.end(),
+							   {first, first + 1, first + 2, first + 2, first + 3, first});
+	}
+
+	void PhysicsRenderer::AddPolygon(const Polygon& polygon, const Transform& transform) {
+		const std::vector<glm::vec2>& points = polygon.GetPoints();
+		uint32_t numPoints = points.size();
+
+		// scale, then rotate, then translate, like the polygon's own transform
+		float cos = glm::cos(transform.rotation);
+		float sin = glm::sin(transform.rotation);
+
+		uint32_t first = m_PolygonVertices.size() / 2;
+		for (const glm::vec2& point : points) {
+			glm::vec2 scaled = point * transform.scale;
+			m_PolygonVertices.push_back(cos * scaled.x - sin * scaled.y + transform.position.x);
+			m_PolygonVertices.push_back(sin * scaled.x + cos * scaled.y + transform.position.y);
+		}
+
+		// polygons are convex, so they can be triangulated as a fan around the first vertex
+		for (uint32_t i = 0; i + 2 < numPoints; i++)
+			m_PolygonIndices.insert(m_PolygonIndices.end(), {first, first + i + 1, first + i + 2});
+	}
+
+	void PhysicsRenderer::AddCapsule(const Capsule& capsule, const Transform& transform) {
+		glm::vec2 axis = capsule.GetHalfLength() *
+						 glm::vec2(glm::cos(transform.rotation), glm::sin(transform.rotation));
+		glm::vec2 start = transform.position - axis;
+		glm::vec2 end = transform.position + axis;
+
+		AddStrip(start, end, capsule.GetRadius());
+		AddDisc(start, capsule.GetRadius());
+		AddDisc(end, capsule.GetRadius());
+	}
+
+	void PhysicsRenderer::AddSegment(const Segment& segment, const Transform& transform) {
+		// scale, then rotate, then translate, like the segment's own transform
+		float cos = glm::cos(transform.rotation);
+		float sin = glm::sin(transform.rotation);
+
+		glm::vec2 start = segment.GetLocalStart() * transform.scale;
+		glm::vec2 end = segment.GetLocalEnd() * transform.scale;
+		AddStrip(glm::vec2(cos * start.x - sin * start.y, sin * start.x + cos * start.y) +
+					 transform.position,
+				 glm::vec2(cos * end.x - sin * end.y, sin * end.x + cos * end.y) +
+					 transform.position,
+				 SEGMENT_WIDTH / 2.0f);
+	}
+
+	void PhysicsRenderer::AddStrip(const glm::vec2& start, const glm::vec2& end, float halfWidth) {
+		glm::vec2 along = end - start;
+		float lengthSqr = glm::dot(along, along);
+		if (lengthSqr == 0.0f)
+			return;
+
+		glm::vec2 side = glm::vec2(-along.y, along.x) * (halfWidth * glm::inversesqrt(lengthSqr));
+
+		uint32_t first = m_PolygonVertices.size() / 2;
+		const glm::vec2 corners[] = {start - side, end - side, end + side, start + side};
+		for (const glm::vec2& corner : corners)
+			m_PolygonVertices.insert(m_PolygonVertices.end(), {corner.x, corner.y});
+
+		m_PolygonIndices.insert(m_PolygonIndices.end(),
+								{first, first + 1, first + 2, first + 2, first + 3, first});
+	}
+
+	void PhysicsRenderer::Submit(const std::vector<float>& vertices,
+								 const std::vector<uint32_t>& indices,
+								 const VertexBufferLayout& layout, const Ref<Shader>& shader,
+								 BatchBuffers& buffers) {
+		if (indices.empty())
+			return;
+
+		uint32_t vertexSize = vertices.size() * sizeof(float);
+		uint32_t indexSize = indices.size() * sizeof(uint32_t);
+
+		// at least double the buffers when they grow, so a batch that grows a little every frame
+		// does not reallocate every frame
+		if (vertexSize > buffers.vertexCapacity || indexSize > buffers.indexCapacity) {
+			buffers.vertexCapacity = glm::max(vertexSize, 2 * buffers.vertexCapacity);
+			buffers.indexCapacity = glm::max(indexSize, 2 * buffers.indexCapacity);
+
+			buffers.vbo = VertexBuffer::Create(nullptr, buffers.vertexCapacity);
+			buffers.ibo = IndexBuffer::Create(nullptr, buffers.indexCapacity);
+			buffers.vao = VertexArray::Create(layout, buffers.vbo, buffers.ibo);
+		}
+
+		// only the part of the index buffer written this frame is drawn
+		buffers.vbo->SetData(vertices.data(), vertexSize);
+		buffers.ibo->SetData(indices.data(), indexSize);
+
+		Renderer::Submit(buffers.vao, shader, glm::mat4(1.0f));
+	}
+} // namespace Fizz
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+
+#include <Nutella/Renderer/VertexArray.hpp>
+#include <Nutella/Renderer/Shader.hpp>
+
+#include "PhysicsEnvironment.hpp"
+#include "Objects/Capsule.hpp"
+#include "Objects/Circle.hpp"
+#include "Objects/Polygon.hpp"
+#include "Objects/Segment.hpp"
+
+namespace Fizz {
+	/* Draws the objects in a physics environment. Rendering is kept out of the physics core so that
+	   environments can be simulated without a graphics context; all GPU resources (shaders, vertex
+	   arrays) used to draw shapes are owned here instead of by the shapes themselves.
+
+	   Objects are drawn in two batches: one of circles, and one of triangle meshes. Every frame,
+	   each object's geometry is moved into world space and appended to a batch, so the whole
+	   environment takes two draw calls no matter how many objects it holds. Shapes that are
+	   neither are built from both; a capsule is a strip with a circle on each end.
+
+	   Each batch is uploaded into the same GPU buffers every frame. The buffers are only
+	   replaced when a batch outgrows them.
+	 */
+	class PhysicsRenderer {
+	  public:
+		PhysicsRenderer();
+		~PhysicsRenderer();
+
+		/* Renders each physics object in the environment. Must be called between
+		   Renderer::BeginScene and Renderer::EndScene. Objects are drawn blended between their
+		   last two steps by the environment's interpolation alpha.
+
+		   @param env: The environment to render
+		 */
+		void Render(PhysicsEnvironment& env);
+
+	  private:
+		/* Appends a circle's bounding quad to the circle batch */
+		void AddCircle(const Circle& circle, const Transform& transform);
+		/* Appends a polygon, triangulated and moved into world space, to the polygon batch */
+		void AddPolygon(const Polygon& polygon, const Transform& transform);
+		/* Appends a capsule's core strip to the polygon batch, and its ends to the circle batch */
+		void AddCapsule(const Capsule& capsule, const Transform& transform);
+		/* Appends a thin strip along a segment to the polygon batch */
+		void AddSegment(const Segment& segment, const Transform& transform);
+
+		/* Appends a quad covering a circle to the circle batch */
+		void AddDisc(const glm::vec2& center, float radius);
+		/* Appends a rectangle extending halfWidth either side of a line to the polygon batch */
+		void AddStrip(const glm::vec2& start, const glm::vec2& end, float halfWidth);
+
+		/* GPU buffers a batch is drawn from, kept between frames */
+		struct BatchBuffers {
+			Nutella::Ref<Nutella::VertexBuffer> vbo;
+			Nutella::Ref<Nutella::IndexBuffer> ibo;
+			Nutella::Ref<Nutella::VertexArray> vao;
+			// sizes of the buffers, in bytes
+			uint32_t vertexCapacity = 0;
+			uint32_t indexCapacity = 0;
+		};
+
+		/* Uploads a batch to its buffers, growing them if the batch does not fit, and draws it
+		   with a single draw call. Empty batches are skipped.
+		 */
+		void Submit(const std::vector<float>& vertices, const std::vector<uint32_t>& indices,
+					const Nutella::VertexBufferLayout& layout,
+					const Nutella::Ref<Nutella::Shader>& shader, BatchBuffers& buffers);
+
+	  private:
+		Nutella::Ref<Nutella::Shader> m_CircleShader;
+		Nutella::Ref<Nutella::Shader> m_MeshShader;
+
+		Nutella::VertexBufferLayout m_CircleLayout;
+		Nutella::VertexBufferLayout m_MeshLayout;
+
+		// batches being built this frame, kept between frames so their storage is reused
+		std::vector<float> m_CircleVertices;
+		std::vector<uint32_t> m_CircleIndices;
+		std::vector<float> m_PolygonVertices;
+		std::vector<uint32_t> m_PolygonIndices;
+
+		BatchBuffers m_CircleBuffers;
+		BatchBuffers m_PolygonBuffers;
+	};
+} // namespace Fizz
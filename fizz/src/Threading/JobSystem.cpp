@@ -0,0 +1,214 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+
+namespace Fizz {
+	// which job system (if any) the current thread works for, and which queue is its own
+	static thread_local const JobSystem* s_WorkerSystem = nullptr;
+	static thread_local uint32_t s_WorkerQueue = 0;
+
+	JobSystem::JobSystem(uint32_t numThreads) : m_QueuedJobs(0), m_Stopping(false) {
+		if (numThreads == 0)
+			numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+		for (uint32_t i = 0; i < numThreads; i++)
+			m_Queues.push_back(Nutella::CreateScope<Queue>());
+
+		// queue 0 is worked by whoever calls Wait
+		for (uint32_t i = 1; i < numThreads; i++)
+			m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+
+	JobSystem::~JobSystem() {
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_Stopping = true;
+		}
+		m_WakeCondition.notify_all();
+
+		for (std::thread& worker : m_Workers)
+			worker.join();
+	}
+
+	JobHandle JobSystem::Schedule(std::function<void()> task,
+								  std::initializer_list<JobHandle> dependencies) {
+		JobHandle job = CreateJob(std::move(task));
+		Submit(job, dependencies);
+		return job;
+	}
+
+	JobHandle JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, RangeTask task,
+									 std::initializer_list<JobHandle> dependencies) {
+		return ParallelFor([count]() { return count; }, grainSize, std::move(task), dependencies);
+	}
+
+	JobHandle JobSystem::ParallelFor(std::function<uint32_t()> count, uint32_t grainSize,
+									 RangeTask task,
+									 std::initializer_list<JobHandle> dependencies) {
+		NT_ASSERT(grainSize > 0, "Grain size must be positive!");
+
+		// shared between the job and all of its chunks
+		Nutella::Ref<RangeTask> rangeTask = Nutella::CreateRef<RangeTask>(std::move(task));
+
+		JobHandle job = CreateJob(nullptr);
+		Job* jobPtr = job.get(); // a job can not own a handle to itself
+		job->m_Task = [this, jobPtr, count = std::move(count), grainSize, rangeTask]() {
+			uint32_t numIndices = count();
+			if (numIndices == 0)
+				return;
+
+			// queue every chunk but the first as a child, then start on the first right away
+			JobHandle parent = jobPtr->shared_from_this();
+			for (uint32_t begin = grainSize; begin < numIndices; begin += grainSize) {
+				uint32_t end = std::min(begin + grainSize, numIndices);
+				Push(CreateJob([rangeTask, begin, end]() { (*rangeTask)(begin, end); }, parent));
+			}
+
+			(*rangeTask)(0, std::min(grainSize, numIndices));
+		};
+
+		Submit(job, dependencies);
+		return job;
+	}
+
+	void JobSystem::Wait(const JobHandle& job) {
+		uint32_t queue = GetQueueIndex();
+
+		while (!job->IsFinished()) {
+			if (JobHandle next = FindJob(queue))
+				Execute(next);
+			else
+				std::this_thread::yield();
+		}
+	}
+
+	JobHandle JobSystem::CreateJob(std::function<void()> task, const JobHandle& parent) {
+		JobHandle job = Nutella::CreateRef<Job>();
+		job->m_Task = std::move(task);
+		job->m_Parent = parent;
+
+		if (parent)
+			parent->m_Unfinished++;
+
+		return job;
+	}
+
+	void JobSystem::Submit(const JobHandle& job, std::initializer_list<JobHandle> dependencies) {
+		for (const JobHandle& dependency : dependencies) {
+			if (!dependency)
+				continue;
+
+			std::lock_guard<std::mutex> lock(dependency->m_DependentsMutex);
+			if (!dependency->m_DependentsReleased) {
+				job->m_PendingDependencies++;
+				dependency->m_Dependents.push_back(job);
+			}
+		}
+
+		// drop the hold taken while scheduling; queue the job now if nothing else is holding it
+		if (--job->m_PendingDependencies == 0)
+			Push(job);
+	}
+
+	void JobSystem::Push(const JobHandle& job) {
+		// counted before it is queued, so the count never drops below the real number of jobs
+		m_QueuedJobs++;
+
+		Queue& queue = *m_Queues[GetQueueIndex()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(job);
+		}
+
+		// take the sleep lock so a worker can not miss the wake up between checking for jobs and
+		// going to sleep
+		{ std::lock_guard<std::mutex> lock(m_SleepMutex); }
+		m_WakeCondition.notify_one();
+	}
+
+	JobHandle JobSystem::Pop(uint32_t queueIndex) {
+		Queue& queue = *m_Queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty())
+			return nullptr;
+
+		// newest job first, its data is most likely still in cache
+		JobHandle job = std::move(queue.jobs.back());
+		queue.jobs.pop_back();
+		m_QueuedJobs--;
+		return job;
+	}
+
+	JobHandle JobSystem::Steal(uint32_t thief) {
+		for (uint32_t i = 1; i < m_Queues.size(); i++) {
+			Queue& victim = *m_Queues[(thief + i) % m_Queues.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (victim.jobs.empty())
+				continue;
+
+			// oldest job first, it is the least likely to be needed soon by its owner
+			JobHandle job = std::move(victim.jobs.front());
+			victim.jobs.pop_front();
+			m_QueuedJobs--;
+			return job;
+		}
+
+		return nullptr;
+	}
+
+	JobHandle JobSystem::FindJob(uint32_t queue) {
+		if (JobHandle job = Pop(queue))
+			return job;
+
+		return Steal(queue);
+	}
+
+	void JobSystem::Execute(const JobHandle& job) {
+		if (job->m_Task)
+			job->m_Task();
+
+		Finish(job);
+	}
+
+	void JobSystem::Finish(const JobHandle& job) {
+		if (--job->m_Unfinished > 0)
+			return;
+
+		std::vector<JobHandle> dependents;
+		{
+			std::lock_guard<std::mutex> lock(job->m_DependentsMutex);
+			job->m_DependentsReleased = true;
+			dependents.swap(job->m_Dependents);
+		}
+
+		for (const JobHandle& dependent : dependents) {
+			if (--dependent->m_PendingDependencies == 0)
+				Push(dependent);
+		}
+
+		if (job->m_Parent)
+			Finish(job->m_Parent);
+	}
+
+	void JobSystem::WorkerLoop(uint32_t queue) {
+		s_WorkerSystem = this;
+		s_WorkerQueue = queue;
+
+		while (true) {
+			if (JobHandle job = FindJob(queue)) {
+				Execute(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_SleepMutex);
+			m_WakeCondition.wait(lock, [this]() { return m_Stopping || m_QueuedJobs > 0; });
+
+			if (m_Stopping)
+				return;
+		}
+	}
+
+	uint32_t JobSystem::GetQueueIndex() const {
+		return s_WorkerSystem == this ? s_WorkerQueue : 0;
+	}
+} // namespace Fizz
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <Nutella.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Fizz {
+	class JobSystem;
+
+	/* A unit of work run by a JobSystem. Jobs are only created through the job system, and are
+	   referred to by handle (see JobHandle).
+
+	   A job may have children; it is not finished until its own work and all of its children's
+	   work is done. A job may also depend on other jobs; it is not started until all of its
+	   dependencies have finished.
+	 */
+	class Job : public std::enable_shared_from_this<Job> {
+	  public:
+		/* Checks whether this job, and all of its children, have finished */
+		inline bool IsFinished() const { return m_Unfinished.load() == 0; }
+
+	  private:
+		friend class JobSystem;
+
+		std::function<void()> m_Task;
+		Nutella::Ref<Job> m_Parent;
+
+		// own work + unfinished children
+		std::atomic<uint32_t> m_Unfinished{1};
+		// unfinished dependencies + 1 while the job is still being scheduled
+		std::atomic<uint32_t> m_PendingDependencies{1};
+
+		// jobs waiting for this job to finish
+		std::mutex m_DependentsMutex;
+		std::vector<Nutella::Ref<Job>> m_Dependents;
+		bool m_DependentsReleased = false;
+	};
+
+	using JobHandle = Nutella::Ref<Job>;
+
+	/* Work stealing scheduler for splitting the simulation across cores. Every thread has its own
+	   queue of jobs. Threads take their newest job first, which keeps related work on the same
+	   core, and steal the oldest job from another thread's queue when they run out, which spreads
+	   out large batches of work.
+
+	   Jobs are scheduled with a list of dependencies, so a pipeline of stages can be submitted up
+	   front and run as a graph, with each stage starting as soon as the stages it needs are done.
+	 */
+	class JobSystem {
+	  public:
+		using RangeTask = std::function<void(uint32_t, uint32_t)>;
+
+		/* Creates a job system and starts its workers.
+
+		   @param numThreads: The total number of threads to run jobs on, including the thread
+		   that calls Wait. 0 uses one thread per hardware core.
+		 */
+		JobSystem(uint32_t numThreads = 0);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		/* Schedules a single task.
+
+		   @param task: The work to do
+		   @param dependencies: Jobs that must finish before the task is started
+
+		   @return A handle to the new job
+		 */
+		JobHandle Schedule(std::function<void()> task,
+						   std::initializer_list<JobHandle> dependencies = {});
+
+		/* Schedules a task over the range [0, count), split into chunks of at most grainSize
+		   indices which may run concurrently. Chunk boundaries depend only on count and grainSize,
+		   never on the number of threads.
+
+		   @param count: The number of indices to process
+		   @param grainSize: The maximum number of indices handed to a thread at once
+		   @param task: Function called as task(begin, end) for each chunk
+		   @param dependencies: Jobs that must finish before any chunk is started
+
+		   @return A handle to a job that finishes once every chunk has finished
+		 */
+		JobHandle ParallelFor(uint32_t count, uint32_t grainSize, RangeTask task,
+							  std::initializer_list<JobHandle> dependencies = {});
+
+		/* Same as above, except that the number of indices is only computed once all
+		   dependencies have finished. Used when the size of the range is produced by an earlier
+		   stage.
+
+		   @param count: Function returning the number of indices to process
+		 */
+		JobHandle ParallelFor(std::function<uint32_t()> count, uint32_t grainSize, RangeTask task,
+							  std::initializer_list<JobHandle> dependencies = {});
+
+		/* Blocks until a job (and all of its children) has finished. The calling thread runs
+		   other jobs while it waits.
+
+		   @param job: The job to wait for
+		 */
+		void Wait(const JobHandle& job);
+
+		/* Gets the number of threads jobs are run on, including the calling thread */
+		inline uint32_t GetThreadCount() const { return m_Queues.size(); }
+
+	  private:
+		struct Queue {
+			std::mutex mutex;
+			std::deque<JobHandle> jobs;
+		};
+
+		JobHandle CreateJob(std::function<void()> task, const JobHandle& parent = nullptr);
+
+		/* Registers dependencies for a job, and queues it if it has none left */
+		void Submit(const JobHandle& job, std::initializer_list<JobHandle> dependencies);
+
+		void Push(const JobHandle& job);
+		JobHandle Pop(uint32_t queue);
+		JobHandle Steal(uint32_t thief);
+		JobHandle FindJob(uint32_t queue);
+
+		void Execute(const JobHandle& job);
+		void Finish(const JobHandle& job);
+
+		void WorkerLoop(uint32_t queue);
+
+		/* Gets the queue belonging to the calling thread */
+		uint32_t GetQueueIndex() const;
+
+	  private:
+		// queue 0 is shared by threads outside the job system, the rest belong to one worker each
+		std::vector<Nutella::Scope<Queue>> m_Queues;
+		std::vector<std::thread> m_Workers;
+
+		// workers sleep while every queue is empty
+		std::atomic<uint32_t> m_QueuedJobs;
+		std::mutex m_SleepMutex;
+		std::condition_variable m_WakeCondition;
+		bool m_Stopping;
+	};
+} // namespace Fizz
@@ -15,6 +15,50 @@ IncludeDir = {}
 IncludeDir["ImGui"] = "nutella/nutella/vendor/imgui"
 IncludeDir["glm"] = "nutella/nutella/vendor/glm"
 
+project "FizzCore"
+    location "fizz"
+    kind "StaticLib"
+
+    language "C++"
+    cppdialect "C++17"
+    staticruntime "Off"
+
+    targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+    -- everything needed to simulate an environment; nothing here may require a graphics context
+    files {
+        "%{prj.location}/src/**.cpp",
+        "%{prj.location}/src/**.hpp",
+    }
+
+    removefiles {
+        "%{prj.location}/src/Fizz.cpp",
+        "%{prj.location}/src/Rendering/**",
+    }
+
+    includedirs {
+        "%{prj.location}/src",
+        "nutella/nutella/src",
+        "nutella/nutella/vendor/spdlog/include",
+        "%{IncludeDir.glm}"
+    }
+
+    filter "configurations:Debug"
+        defines {"NT_DEBUG", "NT_ENABLE_ASSERTS", "NT_PROFILE"}
+        runtime "Debug"
+        symbols "On"
+
+    filter "configurations:Release"
+        defines {"NT_RELEASE", "NT_PROFILE"}
+        runtime "Release"
+        optimize "On"
+
+    filter "configurations:Dist"
+        defines "NT_DIST"
+        runtime "Release"
+        optimize "On"
+
 project "Fizz"
     location "fizz"
     kind "ConsoleApp"
@@ -26,12 +70,18 @@ project "Fizz"
     targetdir ("bin/" .. outputdir .. "/%{prj.name}")
     objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
 
-    links "Nutella"
+    links {"FizzCore", "Nutella"}
     runpathdirs "%{cfg.targetdir}" -- adds relatively (i.e. this is $ORIGIN)
 
+    -- FizzCore simulates on worker threads
+    filter "system:linux"
+        links {"pthread"}
+    filter {}
+
     files {
-        "%{prj.location}/src/**.cpp",
-        "%{prj.location}/src/**.hpp",
+        "%{prj.location}/src/Fizz.cpp",
+        "%{prj.location}/src/Rendering/**.cpp",
+        "%{prj.location}/src/Rendering/**.hpp",
     }
 
     includedirs {
@@ -57,6 +107,52 @@ project "Fizz"
         runtime "Release"
         optimize "On"
 
+project "FizzBench"
+    location "fizz"
+    kind "ConsoleApp"
+
+    language "C++"
+    cppdialect "C++17"
+    staticruntime "Off"
+
+    targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+    links {"FizzCore", "Nutella"}
+    runpathdirs "%{cfg.targetdir}" -- adds relatively (i.e. this is $ORIGIN)
+
+    filter "system:linux"
+        links {"pthread"}
+    filter {}
+
+    -- headless timing scenarios for the physics core; like FizzCore, no graphics context needed
+    files {
+        "%{prj.location}/bench/**.cpp",
+        "%{prj.location}/bench/**.hpp",
+    }
+
+    includedirs {
+        "%{prj.location}/src",
+        "nutella/nutella/src",
+        "nutella/nutella/vendor/spdlog/include",
+        "%{IncludeDir.glm}"
+    }
+
+    filter "configurations:Debug"
+        defines {"NT_DEBUG", "NT_ENABLE_ASSERTS", "NT_PROFILE"}
+        runtime "Debug"
+        symbols "On"
+
+    filter "configurations:Release"
+        defines {"NT_RELEASE", "NT_PROFILE"}
+        runtime "Release"
+        optimize "On"
+
+    filter "configurations:Dist"
+        defines "NT_DIST"
+        runtime "Release"
+        optimize "On"
+
 
 premake.override(gmake2, 'projectrules', function(base, wks)
     local project = p.project